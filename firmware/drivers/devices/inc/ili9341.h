@@ -33,6 +33,10 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 18/01/2024 | Document creation		                         |
+ * | 19/10/2026 | SPI device is registered only once at init     |
+ * | 19/10/2026 | Drawing primitives use SPI burst mode          |
+ * | 19/10/2026 | Fill and pictures use large DMA transfers      |
+ * | 19/10/2026 | ILI9341Benchmark (ILI9341_BENCHMARK)           |
  *
  */
 
@@ -274,6 +278,18 @@ void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
  */
 uint8_t ILI9341DeInit(void);
 
+#ifdef ILI9341_BENCHMARK
+/**
+ * @brief  		Times full screen fills and text rendering and prints the results on the console
+ * @note		Built with the ILI9341_BENCHMARK compile definition, set in the project CMakeLists.txt
+ * 				before project(): idf_build_set_property(COMPILE_DEFINITIONS "ILI9341_BENCHMARK" APPEND)
+ * @note		Call it after ILI9341Init(). It overwrites the whole screen.
+ * @param[in]  	frames: Number of fills and of full screens of text
+ * @retval 		None
+ */
+void ILI9341Benchmark(uint16_t frames);
+#endif
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
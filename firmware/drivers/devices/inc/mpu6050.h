@@ -17,12 +17,30 @@
  * |   Date	| Description                                    			|
  * |:----------:|:----------------------------------------------------------------------|
  * | 30/01/2024 | Document creation		                         		|
+ * | 19/10/2026 | Register shadow cache enabled at initialization		|
+ * | 19/10/2026 | Maximum I2C clock and retries registered at initialization	|
+ * | 19/10/2026 | FIFO burst acquisition driven by the data ready interrupt	|
+ * | 19/10/2026 | DMP (MotionApps 2.0) firmware upload and packet parsing	|
+ * | 19/10/2026 | Offset calibration stored in NVS and restored at initialization	|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include "i2c_mcu.h"
 /*==================[macros]=================================================*/
+#define MPU6050_MAX_CLOCK_HZ        I2C_FAST_FREQ_HZ    /*!< Maximum I2C clock supported by the MPU6050 */
+#define MPU6050_I2C_RETRIES         2                   /*!< Retries after a failed I2C transfer */
+#define MPU6050_FIFO_SIZE           1024                /*!< FIFO size in bytes */
+#define MPU6050_FIFO_SAMPLE_SIZE    12                  /*!< Bytes per FIFO sample (accel + gyro) */
+#define MPU6050_FIFO_MAX_SAMPLES    (MPU6050_FIFO_SIZE / MPU6050_FIFO_SAMPLE_SIZE)	/*!< Samples that fit in the FIFO */
+#define MPU6050_FIFO_BURST_SAMPLES  21                  /*!< Samples read in each I2C transaction (252 bytes) */
+#define MPU6050_FIFO_TASK_STACK     3072                /*!< Stack size of the acquisition task */
+#define MPU6050_CALIB_SAMPLES       500                 /*!< Default number of samples averaged by the calibration */
+#define MPU6050_CALIB_PASSES        2                   /*!< Calibration passes (each one refines the previous offsets) */
+#define MPU6050_CALIB_MAX_ACCEL_SPREAD 0.1f             /*!< Calibration: maximum accelerometer peak to peak spread in g */
+#define MPU6050_CALIB_MAX_GYRO_SPREAD  5.0f             /*!< Calibration: maximum gyroscope peak to peak spread in degrees/s */
+#define MPU6050_NVS_NAMESPACE       "mpu6050"           /*!< NVS namespace of the stored offsets */
+#define MPU6050_NVS_KEY             "offsets"           /*!< NVS key of the stored offsets */
 #undef pgm_read_byte
 #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
 //#define PROGMEM /* empty */
@@ -30,6 +48,10 @@
 //#define pgm_read_word(x) (*(x))
 //#define pgm_read_float(x) (*(x))
 //#define PSTR(STR) STR
+/* DMP (MotionApps 2.0) functions are built with the MPU6050_INCLUDE_DMP_MOTIONAPPS20 compile 
+ * definition, set in the project CMakeLists.txt before project(): 
+ * idf_build_set_property(COMPILE_DEFINITIONS "MPU6050_INCLUDE_DMP_MOTIONAPPS20" APPEND) 
+ * The firmware image is provided by the application (MPU6050_dmpInitialize()). */
 //#define MPU6050_INCLUDE_DMP_MOTIONAPPS20
 #define MPU6050_ADDRESS_AD0_LOW     0x68 // address pin low (GND), default for InvenSense evaluation board
 #define MPU6050_ADDRESS_AD0_HIGH    0x69 // address pin high (VCC)
@@ -407,9 +429,35 @@
 #define MPU6050_DMP_MEMORY_BANKS        8
 #define MPU6050_DMP_MEMORY_BANK_SIZE    256
 #define MPU6050_DMP_MEMORY_CHUNK_SIZE   16
-// note: DMP code memory blocks defined at end of header file
+#define MPU6050_DMP_CODE_SIZE           1929    /*!< MotionApps 2.0 firmware image size */
+#define MPU6050_DMP_START_ADDRESS       0x0300  /*!< MotionApps 2.0 program start address */
+#define MPU6050_DMP_PACKET_SIZE         42      /*!< MotionApps 2.0 FIFO packet size */
+#define MPU6050_DMP_FIFO_RATE_DIVISOR   0x01    /*!< DMP output rate = 200 Hz / (1 + divisor) */
+// note: the DMP firmware image is not part of the driver, it is passed to MPU6050_dmpInitialize()
 
 /*==================[typedef]================================================*/
+/**
+ * @brief Scaled sample delivered by the FIFO acquisition
+ */
+typedef struct {
+	int64_t timestamp;		/*!< Sample time in us (esp_timer time base) */
+	float accel[3];			/*!< X, Y, Z acceleration in g */
+	float gyro[3];			/*!< X, Y, Z angular rate in degrees/s */
+} mpu6050_sample_t;
+
+/**
+ * @brief FIFO acquisition configuration
+ */
+typedef struct {
+	gpio_t int_pin;			/*!< GPIO connected to the MPU6050 INT pin */
+	uint16_t sample_rate;	/*!< Sample rate in Hz (4 to 1000) */
+	uint8_t dlpf_mode;		/*!< Digital low pass filter (MPU6050_DLPF_BW_x) */
+	uint8_t batch_size;		/*!< Samples per batch (1 to MPU6050_FIFO_MAX_SAMPLES) */
+	void *func_p;			/*!< Pointer to the function called from the acquisition task with each batch: 
+								void func(mpu6050_sample_t *samples, uint8_t count, void *param_p) */
+	void *param_p;			/*!< Pointer to callback parameter */
+	uint8_t task_priority;	/*!< Acquisition task priority */
+} mpu6050_fifo_config_t;
 
 /*==================[external data declaration]==============================*/
 
@@ -429,7 +477,8 @@ void MPU6050_ReadRegister(uint8_t reg, uint8_t *data, uint8_t len);
  * after start-up). This function also sets both the accelerometer and the gyroscope
  * to their most sensitive settings, namely +/- 2g and +/- 250 degrees/sec, and sets
  * the clock source to use the X Gyro for reference, which is slightly better than
- * the default internal clock source.
+ * the default internal clock source. Offsets stored by MPU6050_saveOffsets() are restored 
+ * if NVS was initialized before.
  */
 void MPU6050_initialize();
 
@@ -1845,9 +1894,10 @@ void MPU6050_getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int1
  * @param gz 16-bit signed integer container for gyroscope Z-axis value
  * @see getAcceleration()
  * @see getRotation()
+ * @return true if the 14 bytes were read (the outputs are not written otherwise)
  * @see MPU6050_RA_ACCEL_XOUT_H
  */
-void MPU6050_getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz);
+bool MPU6050_getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz);
 
 /** Get 3-axis accelerometer readings.
  * These registers store the most recent accelerometer measurements.
@@ -2642,11 +2692,14 @@ uint16_t MPU6050_getFIFOCount();
 uint8_t MPU6050_getFIFOByte();
 void MPU6050_setFIFOByte(uint8_t data);
 
-/** Write byte to FIFO buffer.
+/** Read bytes from FIFO buffer.
+ * The read is not retried: after a failure the FIFO read position is unknown and the 
+ * FIFO must be reset (MPU6050_resetFIFO()).
  * @see getFIFOByte()
  * @see MPU6050_RA_FIFO_R_W
+ * @return true if length bytes were read
  */
-void MPU6050_getFIFOBytes(uint8_t *data, uint8_t length);
+bool MPU6050_getFIFOBytes(uint8_t *data, uint8_t length);
 
 // WHO_AM_I register
 /** Get Device ID.
@@ -2669,6 +2722,209 @@ uint8_t MPU6050_getDeviceID();
  */
 void MPU6050_setDeviceID(uint8_t id);
 
+/** @fn MPU6050_fifoStart(mpu6050_fifo_config_t *config)
+ * @brief Start the FIFO burst acquisition. Accel and gyro samples are stored in the FIFO at 
+ * the sample rate; the INT pin pulses with each new sample and the acquisition task is woken 
+ * once per batch to read the whole FIFO in bursts of MPU6050_FIFO_BURST_SAMPLES samples.
+ * @note The INT pin is configured active high, push-pull, 50 us pulse.
+ * @note Timestamps are taken from the last data ready interrupt and spaced by the sample period.
+ * @note The FIFO is reset (and the samples dropped) when an overflow is detected.
+ * @param config Acquisition configuration
+ * @return true if the acquisition was started
+ */
+bool MPU6050_fifoStart(mpu6050_fifo_config_t *config);
+
+/** @fn MPU6050_fifoStop(void)
+ * @brief Stop the FIFO acquisition (disable the data ready interrupt and the FIFO)
+ */
+void MPU6050_fifoStop(void);
+
+/** @fn MPU6050_fifoGetOverflowCount(void)
+ * @brief Number of FIFO overflows and failed FIFO reads since the acquisition was started
+ * @note Both reset the FIFO: the samples not yet read are lost
+ * @return Overflow count
+ */
+uint32_t MPU6050_fifoGetOverflowCount(void);
+
+/** @fn MPU6050_fifoGetSamplePeriod(void)
+ * @brief Actual sample period (the sample rate divider is an integer)
+ * @return Sample period in us
+ */
+uint32_t MPU6050_fifoGetSamplePeriod(void);
+
+/** @fn MPU6050_setDMPEnabled(bool enabled)
+ * @brief Enable or disable the Digital Motion Processor
+ * @param enabled New DMP enabled status
+ * @see MPU6050_RA_USER_CTRL
+ * @see MPU6050_USERCTRL_DMP_EN_BIT
+ */
+void MPU6050_setDMPEnabled(bool enabled);
+
+/** @fn MPU6050_resetDMP(void)
+ * @brief Reset the Digital Motion Processor (the bit clears itself)
+ * @see MPU6050_USERCTRL_DMP_RESET_BIT
+ */
+void MPU6050_resetDMP(void);
+
+/** @fn MPU6050_setOTPBankValid(bool enabled)
+ * @brief Set the OTP bank valid flag
+ * @param enabled New OTP bank valid flag
+ * @see MPU6050_RA_XG_OFFS_TC
+ */
+void MPU6050_setOTPBankValid(bool enabled);
+
+/** @fn MPU6050_setMemoryBank(uint8_t bank, bool prefetchEnabled, bool userBank)
+ * @brief Select the DMP memory bank used by the memory access registers
+ * @param bank Memory bank (0 to 31)
+ * @param prefetchEnabled Enable prefetch
+ * @param userBank Select the user bank
+ * @see MPU6050_RA_BANK_SEL
+ */
+void MPU6050_setMemoryBank(uint8_t bank, bool prefetchEnabled, bool userBank);
+
+/** @fn MPU6050_setMemoryStartAddress(uint8_t address)
+ * @brief Set the DMP memory address (auto-incremented on each MEM_R_W access)
+ * @param address Address inside the selected bank
+ * @see MPU6050_RA_MEM_START_ADDR
+ */
+void MPU6050_setMemoryStartAddress(uint8_t address);
+
+/** @fn MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address)
+ * @brief Read a block of DMP memory (it can cross bank boundaries)
+ * @param data Buffer for the data read
+ * @param dataSize Number of bytes
+ * @param bank First bank
+ * @param address First address inside the bank
+ */
+void MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address);
+
+/** @fn MPU6050_writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify)
+ * @brief Write a block of DMP memory in MPU6050_DMP_MEMORY_CHUNK_SIZE bytes transactions
+ * @param data Data to write
+ * @param dataSize Number of bytes
+ * @param bank First bank
+ * @param address First address inside the bank
+ * @param verify Read back and compare each chunk
+ * @return true if the block was written (and verified)
+ */
+bool MPU6050_writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify);
+
+#ifdef MPU6050_INCLUDE_DMP_MOTIONAPPS20
+/** @fn MPU6050_dmpInitialize(const uint8_t *image, uint16_t size)
+ * @brief Upload the MotionApps 2.0 firmware and configure the DMP. The DMP is left disabled, 
+ * call MPU6050_setDMPEnabled(true) to start it.
+ * @note The firmware image (MPU6050_DMP_CODE_SIZE bytes, InvenSense MotionApps 2.0) is provided 
+ * by the application.
+ * @note The DMP output rate is 200 Hz / (1 + MPU6050_DMP_FIFO_RATE_DIVISOR); the INT pin 
+ * pulses with each packet.
+ * @note The device is reset: the offsets stored by MPU6050_saveOffsets() are restored, 
+ * offsets written since (MPU6050_calibrate() without save) are lost.
+ * @param image Firmware image
+ * @param size Firmware image size
+ * @return true if the firmware was uploaded and verified
+ */
+bool MPU6050_dmpInitialize(const uint8_t *image, uint16_t size);
+
+/** @fn MPU6050_dmpGetLatestPacket(uint8_t *packet)
+ * @brief Drain the FIFO and keep the newest DMP packet
+ * @note The FIFO is reset if it overflowed or a read failed (sample boundaries are lost).
+ * @param packet Buffer of MPU6050_DMP_PACKET_SIZE bytes
+ * @return true if a packet was read
+ */
+bool MPU6050_dmpGetLatestPacket(uint8_t *packet);
+
+/** @fn MPU6050_dmpGetQuaternion(float *q, const uint8_t *packet)
+ * @brief Orientation quaternion (w, x, y, z) of a DMP packet
+ * @param q Container for the normalized quaternion
+ * @param packet DMP packet
+ */
+void MPU6050_dmpGetQuaternion(float *q, const uint8_t *packet);
+
+/** @fn MPU6050_dmpGetAccel(int16_t *a, const uint8_t *packet)
+ * @brief Raw acceleration (x, y, z) of a DMP packet
+ * @param a Container for the acceleration
+ * @param packet DMP packet
+ */
+void MPU6050_dmpGetAccel(int16_t *a, const uint8_t *packet);
+
+/** @fn MPU6050_dmpGetGyro(int16_t *g, const uint8_t *packet)
+ * @brief Raw angular rate (x, y, z) of a DMP packet
+ * @param g Container for the angular rate
+ * @param packet DMP packet
+ */
+void MPU6050_dmpGetGyro(int16_t *g, const uint8_t *packet);
+
+/** @fn MPU6050_dmpGetGravity(float *v, const float *q)
+ * @brief Gravity direction (x, y, z) in the sensor frame
+ * @param v Container for the gravity vector (in g)
+ * @param q Orientation quaternion
+ */
+void MPU6050_dmpGetGravity(float *v, const float *q);
+
+/** @fn MPU6050_dmpGetYawPitchRoll(float *ypr, const float *q, const float *gravity)
+ * @brief Yaw, pitch and roll angles
+ * @param ypr Container for the angles in radians
+ * @param q Orientation quaternion
+ * @param gravity Gravity vector (from MPU6050_dmpGetGravity)
+ */
+void MPU6050_dmpGetYawPitchRoll(float *ypr, const float *q, const float *gravity);
+#endif
+
+/** @fn MPU6050_getAccelOffsets(int16_t *offsets)
+ * @brief Read the accelerometer offset registers (+/- 16g scale, bit 0 is reserved)
+ * @param offsets Container for the X, Y, Z offsets
+ * @see MPU6050_RA_XA_OFFS_H
+ */
+void MPU6050_getAccelOffsets(int16_t *offsets);
+
+/** @fn MPU6050_setAccelOffsets(const int16_t *offsets)
+ * @brief Write the accelerometer offset registers (bit 0 of each register is preserved)
+ * @param offsets X, Y, Z offsets
+ * @see MPU6050_RA_XA_OFFS_H
+ */
+void MPU6050_setAccelOffsets(const int16_t *offsets);
+
+/** @fn MPU6050_getGyroOffsets(int16_t *offsets)
+ * @brief Read the gyroscope user offset registers (+/- 1000 degrees/s scale)
+ * @param offsets Container for the X, Y, Z offsets
+ * @see MPU6050_RA_XG_OFFS_USRH
+ */
+void MPU6050_getGyroOffsets(int16_t *offsets);
+
+/** @fn MPU6050_setGyroOffsets(const int16_t *offsets)
+ * @brief Write the gyroscope user offset registers
+ * @param offsets X, Y, Z offsets
+ * @see MPU6050_RA_XG_OFFS_USRH
+ */
+void MPU6050_setGyroOffsets(const int16_t *offsets);
+
+/** @fn MPU6050_calibrate(uint16_t samples)
+ * @brief Average stationary samples and write the accel and gyro offset registers so that 
+ * the device reads 0 g, 0 g, +1 g and 0 degrees/s
+ * @note The device must be still, with the Z axis pointing up. Samples are read every 
+ * 2 ms (DelayUs), so it takes about MPU6050_CALIB_PASSES * samples * 2 ms.
+ * @param samples Samples averaged in each pass (0: MPU6050_CALIB_SAMPLES)
+ * @return true if the offsets were written, false on an I2C error or if the peak to peak 
+ * spread of an axis exceeds MPU6050_CALIB_MAX_ACCEL_SPREAD or MPU6050_CALIB_MAX_GYRO_SPREAD 
+ * (the device moved); the previous offsets are restored in that case
+ */
+bool MPU6050_calibrate(uint16_t samples);
+
+/** @fn MPU6050_saveOffsets(void)
+ * @brief Store the current offset registers in NVS
+ * @note The application must initialize NVS first (nvs_flash_init(), erasing the partition 
+ * on ESP_ERR_NVS_NO_FREE_PAGES or ESP_ERR_NVS_NEW_VERSION_FOUND)
+ * @return true if the offsets were stored
+ */
+bool MPU6050_saveOffsets(void);
+
+/** @fn MPU6050_loadOffsets(void)
+ * @brief Restore the offset registers from NVS (MPU6050_initialize() calls it)
+ * @note NVS must be initialized by the application, see MPU6050_saveOffsets()
+ * @return true if stored offsets were found and written
+ */
+bool MPU6050_loadOffsets(void);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
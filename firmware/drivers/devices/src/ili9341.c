@@ -10,23 +10,30 @@
  */
 
 /*==================[inclusions]=============================================*/
+#include <stddef.h>
 #include "ili9341.h"
 #include "fonts.h"
 #include "spi_mcu.h"
 #include "gpio_mcu.h"
 #include "delay_mcu.h"
+#ifdef ILI9341_BENCHMARK
+#include <stdio.h>
+#include "esp_timer.h"
+#endif
 /*==================[macros and definitions]=================================*/
-#define NULL 0
 
 #define SPI_BR 20000000				/*!< Frequency of sck for SPI communication */
 #define MAX_PIXEL 320*240*2			/*!< Maximum number of bytes to write on LCD */
 #define MSK_BIT16 0x8000			/*!< 16th bit mask */
 #define MSK_BIT8 0x80				/*!< 8th bit mask */
 #define MAX_VALUE_SIZE 256			/*!< Maximum length of a data array to prevent excessive use of memory */
+#define FILL_BUFFER_SIZE 4096		/*!< Size of the DMA buffer used to fill areas with a color */
 #define LEFT -1						/*!< Horizontal grow direction */
 #define RIGHT 1						/*!< Horizontal grow direction */
 #define DOWN 1						/*!< Vertical grow direction */
 #define UP -1						/*!< Vertical grow direction */
+#define DC_CMD		((void*)0)		/*!< DC level while sending a command */
+#define DC_DATA		((void*)1)		/*!< DC level while sending parameters or data */
 
 /* Command List */
 #define RESET				0x01 	/*!< Resets the commands and parameters to their S/W Reset default values */
@@ -114,6 +121,13 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
  */
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
+/**
+ * @brief  		Drive DC pin before each SPI transaction (SPI pre-transaction callback)
+ * @param[in]  	dc: DC_CMD or DC_DATA
+ * @retval 		None
+ */
+static void SetDC(void * dc);
+
 /*==================[internal data definition]===============================*/
 /**
  * @brief Initial LCD configuration parameters
@@ -167,20 +181,21 @@ lcd_cmd_t lcd_init[] = {
 	{NEG_GAMMA, 15, neg_gamma},
 };
 
-lcd_cmd_t lcd_reset = {RESET, NULL, NULL};			/*!< SW reset */
-lcd_cmd_t lcd_sleep_out = {SLEEP_OUT, NULL, NULL};	/*!< Exit sleep mode */
-lcd_cmd_t lcd_on = {DISPLAY_ON, NULL, NULL};		/*!< Exit sleep mode */
+lcd_cmd_t lcd_reset = {RESET, 0, NULL};			/*!< SW reset */
+lcd_cmd_t lcd_sleep_out = {SLEEP_OUT, 0, NULL};	/*!< Exit sleep mode */
+lcd_cmd_t lcd_on = {DISPLAY_ON, 0, NULL};		/*!< Exit sleep mode */
 
 /*
  * @brief: SPI port configuration compatible with LCD interface
  */
 spi_mcu_config_t spi_conf = {
-	.device = NULL, 
+	.device = SPI_1, 
 	.clk_mode = MODE0, 
 	.bitrate = SPI_BR, 
 	.transfer_mode = SPI_POLLING, 
 	.func_p = NULL,
-	.param_p = NULL };
+	.param_p = NULL,
+	.pre_func_p = SetDC };
 
 static spi_dev_t ili9341_spi;				/*!< uC SPI port */
 static gpio_t ili9341_dc, ili9341_rst;		/*!< uC GPIO ports to use as CS, DC and RST */
@@ -193,20 +208,28 @@ static orientation_properties_t lcd_orientation = {
 
 /*==================[internal functions definition]==========================*/
 
+static void SetDC(void * dc){
+	GPIOState(ili9341_dc, dc == DC_DATA);
+}
+
 void WriteLCD(lcd_cmd_t * data){
-	SpiInit(&spi_conf);
-	/* If command is NULL don't send command */
-	if (data->cmd != NULL){
+	/* Command and data go out back-to-back, DC is driven by SetDC() before each transaction */
+	SpiBurstBegin(ili9341_spi);
+	/* If command is 0 don't send command */
+	if (data->cmd != 0){
 		/* Send command */
-		GPIOOff(ili9341_dc);
-		SpiWrite(ili9341_spi, &data->cmd, 1);
+		if (!SpiBurstWrite(ili9341_spi, &data->cmd, 1, DC_CMD)){
+			/* Parameters without their command would be taken as a new command */
+			SpiBurstEnd(ili9341_spi);
+			return;
+		}
 	}
 	/* If there are parameters or data to send */
-	if (data->databytes != NULL){
+	if (data->databytes != 0){
 		/* Send parameters or data */
-		GPIOOn(ili9341_dc);
-		SpiWrite(ili9341_spi, data->data, data->databytes);
+		SpiBurstWrite(ili9341_spi, data->data, data->databytes, DC_DATA);
 	}
+	SpiBurstEnd(ili9341_spi);
 }
 
 void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1){
@@ -227,8 +250,10 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1){
 	lcd_cmd_t lcd_columns = {COLUMN_ADDR_SET, 4, columns};
 	uint8_t rows[] = {HighByte(y0), LowByte(y0), HighByte(y1), LowByte(y1)};
 	lcd_cmd_t lcd_rows = {PAGE_ADDR_SET, 4, rows};
+	SpiBurstBegin(ili9341_spi);
 	WriteLCD(&lcd_columns);
 	WriteLCD(&lcd_rows);
+	SpiBurstEnd(ili9341_spi);
 }
 
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
@@ -236,6 +261,20 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
 	static int32_t bytes_count;
 	static int16_t x_dist, y_dist;
 	static uint8_t pixel[MAX_VALUE_SIZE];
+	static uint8_t *fill_buffer = NULL;
+	static uint16_t fill_size = MAX_VALUE_SIZE;
+	uint8_t *buffer = pixel;
+
+	/* A DMA capable buffer is allocated once, so DMA reads it directly in big transactions */
+	if (fill_buffer == NULL){
+		fill_buffer = SpiDmaMalloc(FILL_BUFFER_SIZE);
+		if (fill_buffer != NULL){
+			fill_size = FILL_BUFFER_SIZE;
+		}
+	}
+	if (fill_buffer != NULL){
+		buffer = fill_buffer;
+	}
 
 	x_dist = x1 - x0;
 	y_dist = y1 - y0;
@@ -247,24 +286,27 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
 	}
 	/* Number of bytes to write. We have to write 2 bytes/pixel (16bits color) */
 	bytes_count = (x_dist + 1) * (y_dist + 1) * 2;
+	/* Keep the bus for the whole drawing (cursor, memory write and pixels) */
+	SpiBurstBegin(ili9341_spi);
 	/* Define area to fill */
 	SetCursorPosition(x0, y0, x1, y1);
 
-	for (i = 0; i < MAX_VALUE_SIZE; i += 2){
-		pixel[i] = HighByte(color);
-		pixel[i + 1] = LowByte(color);
+	for (i = 0; i < fill_size; i += 2){
+		buffer[i] = HighByte(color);
+		buffer[i + 1] = LowByte(color);
 	}
 	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
+	lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
 	WriteLCD(&lcd_write);
 
-	while(bytes_count - MAX_VALUE_SIZE > 0){
-		lcd_cmd_t lcd_pixel = {NULL, MAX_VALUE_SIZE, pixel};
+	while(bytes_count - fill_size > 0){
+		lcd_cmd_t lcd_pixel = {0, fill_size, buffer};
 		WriteLCD(&lcd_pixel);
-		bytes_count -= MAX_VALUE_SIZE;
+		bytes_count -= fill_size;
 	}
-	lcd_cmd_t lcd_pixel = {NULL, bytes_count, pixel};
+	lcd_cmd_t lcd_pixel = {0, bytes_count, buffer};
 	WriteLCD(&lcd_pixel);
+	SpiBurstEnd(ili9341_spi);
 }
 
 /*==================[external functions definition]==========================*/
@@ -273,6 +315,10 @@ uint8_t ILI9341Init(spi_dev_t spi_dev, uint8_t gpio_dc, uint8_t gpio_rst){
 	/* SPI configuration */
 	spi_conf.device = spi_dev;
 	ili9341_spi = spi_dev;
+	/* The device is registered once, re-initializing the display reuses it */
+	if(!SpiIsInitialized(spi_dev)){
+		SpiInit(&spi_conf);
+	}
 	/* GPIOs configuration and initialization */
 	ili9341_dc = gpio_dc;
 	ili9341_rst = gpio_rst;
@@ -303,11 +349,14 @@ uint8_t ILI9341Init(spi_dev_t spi_dev, uint8_t gpio_dc, uint8_t gpio_rst){
 }
 
 void ILI9341DrawPixel(uint16_t x, uint16_t y, uint16_t color){
+	/* Keep the bus for the whole drawing (cursor, memory write and pixels) */
+	SpiBurstBegin(ili9341_spi);
 	/* Define area (pixel) to fill */
 	SetCursorPosition(x, y, x, y);
 	uint8_t pixels[] = {HighByte(color), LowByte(color)};
 	lcd_cmd_t lcd_pixels = {MEM_WRITE, sizeof(pixels), pixels};
 	WriteLCD(&lcd_pixels);
+	SpiBurstEnd(ili9341_spi);
 }
 
 void ILI9341Fill(uint16_t color){
@@ -366,13 +415,15 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t f
 		lcd_x = 0;
 	}
 
+	/* Keep the bus for the whole drawing (cursor, memory write and pixels) */
+	SpiBurstBegin(ili9341_spi);
 	SetCursorPosition(lcd_x, lcd_y, lcd_x + font->info[data - ' '].width - 1, lcd_y + font->font_height - 1);
 
 	/* Number of bytes to write. We have to write 2 bytes/pixel */
 	bytes_count = font->font_height * font->info[data - ' '].width * 2;
 
 	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
+	lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
 	WriteLCD(&lcd_write);
 
 	/* Draw font data */
@@ -389,7 +440,7 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t f
 			}
 			/* If exceed buffer size, send buffer */
 			if ((2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE){
-				lcd_cmd_t lcd_pixels = {NULL, MAX_VALUE_SIZE, pixel};
+				lcd_cmd_t lcd_pixels = {0, MAX_VALUE_SIZE, pixel};
 				WriteLCD(&lcd_pixels);
 				bytes_count -= MAX_VALUE_SIZE;
 				k++;
@@ -407,8 +458,9 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t f
 		}
 	}
 	/* Send the rest of the buffer */
-	lcd_cmd_t lcd_pixels = {NULL, bytes_count, pixel};
+	lcd_cmd_t lcd_pixels = {0, bytes_count, pixel};
 	WriteLCD(&lcd_pixels);
+	SpiBurstEnd(ili9341_spi);
 }
 
 void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font, uint16_t foreground, uint16_t background){
@@ -428,13 +480,15 @@ void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font
 		lcd_x = 0;
 	}
 
+	/* Keep the bus for the whole drawing (cursor, memory write and pixels) */
+	SpiBurstBegin(ili9341_spi);
 	SetCursorPosition(lcd_x, lcd_y, lcd_x + icon_font->width - 1, lcd_y + icon_font->height - 1);
 
 	/* Number of bytes to write. We have to write 2 bytes/pixel */
 	bytes_count = icon_font->height * icon_font->width * 2;
 
 	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
+	lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
 	WriteLCD(&lcd_write);
 
 	/* Draw font data */
@@ -451,7 +505,7 @@ void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font
 			}
 			/* If exceed buffer size, send buffer */
 			if ((2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE){
-				lcd_cmd_t lcd_pixels = {NULL, MAX_VALUE_SIZE, pixel};
+				lcd_cmd_t lcd_pixels = {0, MAX_VALUE_SIZE, pixel};
 				WriteLCD(&lcd_pixels);
 				bytes_count -= MAX_VALUE_SIZE;
 				k++;
@@ -469,8 +523,9 @@ void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font
 		}
 	}
 	/* Send the rest of the buffer */
-	lcd_cmd_t lcd_pixels = {NULL, bytes_count, pixel};
+	lcd_cmd_t lcd_pixels = {0, bytes_count, pixel};
 	WriteLCD(&lcd_pixels);
+	SpiBurstEnd(ili9341_spi);
 }
 
 void ILI9341DrawInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t* font, uint16_t foreground, uint16_t background){
@@ -800,38 +855,63 @@ void ILI9341DrawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, i
 }
 
 void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pic){
-	static uint16_t i, j;
 	static int32_t bytes_count;
-	static uint8_t pixel[MAX_VALUE_SIZE];
 
+	/* Keep the bus for the whole drawing (cursor, memory write and pixels) */
+	SpiBurstBegin(ili9341_spi);
 	SetCursorPosition(x, y, x + width - 1, y + height - 1);
 
 	/* Number of bytes to write. We have to write 2 bytes/pixel */
 	bytes_count = width * height * 2;
 
 	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
+	lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
 	WriteLCD(&lcd_write);
 
-	j = 0;
-	while(bytes_count - MAX_VALUE_SIZE > 0){
-		for (i = 0; i < MAX_VALUE_SIZE; i++){
-			pixel[i] = pic[j * MAX_VALUE_SIZE + i];
-		}
-		lcd_cmd_t lcd_pixel = {NULL, MAX_VALUE_SIZE, pixel};
-		WriteLCD(&lcd_pixel);
-		bytes_count -= MAX_VALUE_SIZE;
-		j++;
-	}
-	for (i = 0; i < bytes_count; i++){
-		pixel[i] = pic[j * MAX_VALUE_SIZE + i];
-	}
-	lcd_cmd_t lcd_pixel = {NULL, bytes_count, pixel};
+	/* The whole picture is sent in one call, the SPI driver splits it in DMA chunks */
+	lcd_cmd_t lcd_pixel = {0, bytes_count, (uint8_t*)pic};
 	WriteLCD(&lcd_pixel);
+	SpiBurstEnd(ili9341_spi);
 }
 
 uint8_t ILI9341DeInit(void){
-	return 0;
+	return SpiDeInit(ili9341_spi);
+}
+
+#ifdef ILI9341_BENCHMARK
+void ILI9341Benchmark(uint16_t frames){
+	const uint16_t colors[] = {ILI9341_RED, ILI9341_GREEN, ILI9341_BLUE, ILI9341_BLACK};
+	char line[] = "0123456789 ABCDEFGHIJ";
+	uint16_t width, height;
+	uint32_t chars = 0;
+	int64_t start, elapsed;
+
+	if(frames == 0){
+		return;
+	}
+	/* Full screen fills */
+	start = esp_timer_get_time();
+	for(uint16_t i = 0; i < frames; i++){
+		ILI9341Fill(colors[i % 4]);
+	}
+	elapsed = esp_timer_get_time() - start;
+	printf("ILI9341Fill: %u frames in %lu us, %lu.%02lu fps\n", frames, (unsigned long)elapsed,
+		   (unsigned long)(frames * 1000000LL / elapsed), (unsigned long)(frames * 100000000LL / elapsed % 100));
+
+	/* Screens of text: one line per row of characters */
+	ILI9341GetStringSize(line, &font_11, &width, &height);
+	start = esp_timer_get_time();
+	for(uint16_t i = 0; i < frames; i++){
+		for(uint16_t y = 0; y + height <= lcd_orientation.height; y += height){
+			ILI9341DrawString(0, y, line, &font_11, ILI9341_WHITE, colors[i % 4]);
+			chars += sizeof(line) - 1;
+		}
+	}
+	elapsed = esp_timer_get_time() - start;
+	printf("ILI9341DrawString: %lu chars in %lu us, %lu.%02lu screens/s, %lu chars/s\n", (unsigned long)chars,
+		   (unsigned long)elapsed, (unsigned long)(frames * 1000000LL / elapsed),
+		   (unsigned long)(frames * 100000000LL / elapsed % 100), (unsigned long)(chars * 1000000LL / elapsed));
 }
+#endif
 
 /*==================[end of file]============================================*/
@@ -13,32 +13,111 @@
 #include "mpu6050.h"
 #include "math.h"
 #include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "delay_mcu.h"
+#include "nvs.h"
 /*==================[macros and definitions]=================================*/
 #define I2C_NUM I2C_NUM_0
+#define GYRO_RATE_DLPF_OFF		8000		/*!< Gyroscope output rate with the DLPF disabled */
+#define GYRO_RATE_DLPF_ON		1000		/*!< Gyroscope output rate with the DLPF enabled */
+#define ACCEL_LSB_2G			16384.0f	/*!< Accelerometer sensitivity at +/- 2g */
+#define GYRO_LSB_250			131.0f		/*!< Gyroscope sensitivity at +/- 250 degrees/s */
+#define ACCEL_OFFS_LSB			2048.0f		/*!< Accelerometer offset registers sensitivity (+/- 16g) */
+#define GYRO_OFFS_LSB			32.8f		/*!< Gyroscope offset registers sensitivity (+/- 1000 degrees/s) */
+#define CALIB_SAMPLE_US			2000		/*!< Time between calibration samples (shorter than a FreeRTOS tick) */
+
+/**
+ * @brief FIFO acquisition state
+ */
+typedef struct {
+	mpu6050_fifo_config_t config;		/*!< Acquisition configuration */
+	TaskHandle_t task;					/*!< Acquisition task */
+	volatile int64_t last_irq_time;		/*!< Time of the last data ready interrupt */
+	volatile uint8_t irq_count;			/*!< Data ready interrupts since the last batch */
+	uint32_t period_us;					/*!< Sample period */
+	uint32_t overflows;					/*!< FIFO overflows detected */
+	float accel_scale;					/*!< g per LSB */
+	float gyro_scale;					/*!< Degrees/s per LSB */
+} mpu6050_fifo_t;
 
 /*==================[internal data definition]===============================*/
 uint8_t devAddr;
 uint8_t buffer[14];
+static mpu6050_fifo_t mpu6050_fifo;
+static uint8_t fifo_raw[MPU6050_FIFO_BURST_SAMPLES * MPU6050_FIFO_SAMPLE_SIZE];
+static mpu6050_sample_t fifo_samples[MPU6050_FIFO_MAX_SAMPLES];
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief Data ready interrupt: wakes the acquisition task once per batch
+ */
+static void MPU6050_fifoIsr(void *param){
+	BaseType_t woken = pdFALSE;
+	mpu6050_fifo.last_irq_time = esp_timer_get_time();
+	if(++mpu6050_fifo.irq_count >= mpu6050_fifo.config.batch_size){
+		mpu6050_fifo.irq_count = 0;
+		vTaskNotifyGiveFromISR(mpu6050_fifo.task, &woken);
+	}
+	portYIELD_FROM_ISR(woken);
+}
 
-/*==================[external functions definition]==========================*/
-void MPU6050_ReadRegister(uint8_t reg, uint8_t *data, uint8_t len){
-	uint8_t dev = 0x68;
-	i2c_cmd_handle_t cmd;
-	I2C_SelectRegister(dev, reg);
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (dev << 1) | I2C_MASTER_READ, 1));
-
-	if(len>1)
-		ESP_ERROR_CHECK(i2c_master_read(cmd, data, len, I2C_MASTER_ACK));
+/**
+ * @brief Convert a big endian 16 bits value
+ */
+static int16_t MPU6050_toInt16(uint8_t *data){
+	return (int16_t)((((uint16_t)data[0]) << 8) | data[1]);
+}
 
-	ESP_ERROR_CHECK(i2c_master_read_byte(cmd, data+len-1, I2C_MASTER_NACK));
+/**
+ * @brief Acquisition task: drains the FIFO and delivers the scaled samples
+ */
+static void MPU6050_fifoTask(void *pvParameters){
+	uint16_t count, n, i, j, burst;
+	int64_t last_time;
+	uint8_t *raw;
+	while(1){
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		count = MPU6050_getFIFOCount();
+		last_time = mpu6050_fifo.last_irq_time;
+		if(count >= MPU6050_FIFO_SIZE){
+			/* Oldest samples were overwritten: the sample boundaries are lost */
+			mpu6050_fifo.overflows++;
+			MPU6050_resetFIFO();
+			continue;
+		}
+		n = count / MPU6050_FIFO_SAMPLE_SIZE;
+		for(i = 0; i < n; i += burst){
+			burst = (n - i > MPU6050_FIFO_BURST_SAMPLES) ? MPU6050_FIFO_BURST_SAMPLES : n - i;
+			if(!MPU6050_getFIFOBytes(fifo_raw, burst * MPU6050_FIFO_SAMPLE_SIZE)){
+				/* Failed burst: the FIFO read position is unknown, deliver the samples already read */
+				mpu6050_fifo.overflows++;
+				MPU6050_resetFIFO();
+				n = i;
+				break;
+			}
+			for(j = 0; j < burst; j++){
+				raw = &fifo_raw[j * MPU6050_FIFO_SAMPLE_SIZE];
+				mpu6050_sample_t *sample = &fifo_samples[i + j];
+				/* Newest sample belongs to the last interrupt */
+				sample->timestamp = last_time - (int64_t)(n - 1 - i - j) * mpu6050_fifo.period_us;
+				sample->accel[0] = MPU6050_toInt16(&raw[0]) * mpu6050_fifo.accel_scale;
+				sample->accel[1] = MPU6050_toInt16(&raw[2]) * mpu6050_fifo.accel_scale;
+				sample->accel[2] = MPU6050_toInt16(&raw[4]) * mpu6050_fifo.accel_scale;
+				sample->gyro[0] = MPU6050_toInt16(&raw[6]) * mpu6050_fifo.gyro_scale;
+				sample->gyro[1] = MPU6050_toInt16(&raw[8]) * mpu6050_fifo.gyro_scale;
+				sample->gyro[2] = MPU6050_toInt16(&raw[10]) * mpu6050_fifo.gyro_scale;
+			}
+		}
+		if((n > 0) && (mpu6050_fifo.config.func_p != NULL)){
+			((void (*)(mpu6050_sample_t*, uint8_t, void*))mpu6050_fifo.config.func_p)(fifo_samples, n, mpu6050_fifo.config.param_p);
+		}
+	}
+}
 
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000));
-	i2c_cmd_link_delete(cmd);
+/*==================[external functions definition]==========================*/
+void MPU6050_ReadRegister(uint8_t reg, uint8_t *data, uint8_t len){
+	I2C_readBytes(devAddr, reg, len, data, I2C_MASTER_TIMEOUT_MS);
 }
 
 void MPU6050_Address(uint8_t address) {
@@ -47,10 +126,16 @@ void MPU6050_Address(uint8_t address) {
 
 void MPU6050_initialize() {
 	devAddr = MPU6050_DEFAULT_ADDRESS;
+	/* Fast-mode is the MPU6050 limit: it keeps the bus out of Fast-mode Plus */
+	I2C_setDeviceSpeed(devAddr, MPU6050_MAX_CLOCK_HZ, MPU6050_I2C_RETRIES);
+	/* Configuration bit-fields are updated with a single write */
+	I2C_shadowEnable(devAddr);
     MPU6050_setClockSource(MPU6050_CLOCK_PLL_XGYRO);
     MPU6050_setFullScaleGyroRange(MPU6050_GYRO_FS_250);
     MPU6050_setFullScaleAccelRange(MPU6050_ACCEL_FS_2);
     MPU6050_setSleepEnabled(false); // thanks to Jack Elston for pointing this one out!
+    /* Offsets of a previous calibration (factory values if there are none) */
+    MPU6050_loadOffsets();
 }
 
 /** Verify the I2C connection.
@@ -1772,16 +1857,20 @@ void MPU6050_getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int1
  * @param gz 16-bit signed integer container for gyroscope Z-axis value
  * @see getAcceleration()
  * @see getRotation()
+ * @return true if the 14 bytes were read (the outputs are not written otherwise)
  * @see MPU6050_RA_ACCEL_XOUT_H
  */
-void MPU6050_getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz) {
-    I2C_readBytes(devAddr, MPU6050_RA_ACCEL_XOUT_H, 14, buffer, I2C_MASTER_TIMEOUT_MS);
+bool MPU6050_getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz) {
+    if (I2C_readBytes(devAddr, MPU6050_RA_ACCEL_XOUT_H, 14, buffer, I2C_MASTER_TIMEOUT_MS) != 14) {
+        return false;
+    }
     *ax = (((int16_t)buffer[0]) << 8) | buffer[1];
     *ay = (((int16_t)buffer[2]) << 8) | buffer[3];
     *az = (((int16_t)buffer[4]) << 8) | buffer[5];
     *gx = (((int16_t)buffer[8]) << 8) | buffer[9];
     *gy = (((int16_t)buffer[10]) << 8) | buffer[11];
     *gz = (((int16_t)buffer[12]) << 8) | buffer[13];
+    return true;
 }
 /** Get 3-axis accelerometer readings.
  * These registers store the most recent accelerometer measurements.
@@ -2187,6 +2276,8 @@ void MPU6050_setSlaveDelayEnabled(uint8_t num, bool enabled) {
  */
 void MPU6050_resetGyroscopePath() {
     I2C_writeBit(devAddr, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_GYRO_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_SIGNAL_PATH_RESET);
 }
 /** Reset accelerometer signal path.
  * The reset will revert the signal path analog to digital converters and
@@ -2196,6 +2287,8 @@ void MPU6050_resetGyroscopePath() {
  */
 void MPU6050_resetAccelerometerPath() {
     I2C_writeBit(devAddr, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_ACCEL_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_SIGNAL_PATH_RESET);
 }
 /** Reset temperature sensor signal path.
  * The reset will revert the signal path analog to digital converters and
@@ -2205,6 +2298,8 @@ void MPU6050_resetAccelerometerPath() {
  */
 void MPU6050_resetTemperaturePath() {
     I2C_writeBit(devAddr, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_TEMP_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_SIGNAL_PATH_RESET);
 }
 
 // MOT_DETECT_CTRL register
@@ -2374,6 +2469,8 @@ void MPU6050_switchSPIEnabled(bool enabled) {
  */
 void MPU6050_resetFIFO() {
     I2C_writeBit(devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_USER_CTRL);
 }
 /** Reset the I2C Master.
  * This bit resets the I2C Master when set to 1 while I2C_MST_EN equals 0.
@@ -2383,6 +2480,8 @@ void MPU6050_resetFIFO() {
  */
 void MPU6050_resetI2CMaster() {
     I2C_writeBit(devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_USER_CTRL);
 }
 /** Reset all sensor registers and signal paths.
  * When set to 1, this bit resets the signal paths for all sensors (gyroscopes,
@@ -2398,6 +2497,8 @@ void MPU6050_resetI2CMaster() {
  */
 void MPU6050_resetSensors() {
     I2C_writeBit(devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_SIG_COND_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_USER_CTRL);
 }
 
 // PWR_MGMT_1 register
@@ -2409,6 +2510,8 @@ void MPU6050_resetSensors() {
  */
 void MPU6050_reset() {
     I2C_writeBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_DEVICE_RESET_BIT, true);
+    /* Every register returns to its default value */
+    I2C_shadowInvalidateAll(devAddr);
 }
 /** Get sleep mode status.
  * Setting the SLEEP bit in the register puts the device into very low power
@@ -2722,15 +2825,15 @@ uint16_t MPU6050_getFIFOCount() {
  * @return Byte from FIFO buffer
  */
 uint8_t MPU6050_getFIFOByte() {
-    I2C_readByte(devAddr, MPU6050_RA_FIFO_R_W, buffer, I2C_MASTER_TIMEOUT_MS);
+    I2C_readBytesOnce(devAddr, MPU6050_RA_FIFO_R_W, 1, buffer, I2C_MASTER_TIMEOUT_MS);
     return buffer[0];
 }
-void MPU6050_getFIFOBytes(uint8_t *data, uint8_t length) {
+bool MPU6050_getFIFOBytes(uint8_t *data, uint8_t length) {
     if(length > 0){
-        I2C_readBytes(devAddr, MPU6050_RA_FIFO_R_W, length, data, I2C_MASTER_TIMEOUT_MS);
-    } else {
-    	*data = 0;
+        return I2C_readBytesOnce(devAddr, MPU6050_RA_FIFO_R_W, length, data, I2C_MASTER_TIMEOUT_MS) == (int16_t)length;
     }
+    *data = 0;
+    return true;
 }
 /** Write byte to FIFO buffer.
  * @see getFIFOByte()
@@ -2766,4 +2869,386 @@ void MPU6050_setDeviceID(uint8_t id) {
     I2C_writeBits(devAddr, MPU6050_RA_WHO_AM_I, MPU6050_WHO_AM_I_BIT, MPU6050_WHO_AM_I_LENGTH, id);
 }
 
+bool MPU6050_fifoStart(mpu6050_fifo_config_t *config){
+	uint32_t gyro_rate;
+	uint16_t divider;
+	if((config->sample_rate == 0) || (config->batch_size == 0) || (config->batch_size > MPU6050_FIFO_MAX_SAMPLES)){
+		return false;
+	}
+	MPU6050_fifoStop();
+	mpu6050_fifo.config = *config;
+	mpu6050_fifo.irq_count = 0;
+	mpu6050_fifo.overflows = 0;
+	/* Sample rate = gyroscope output rate / (1 + SMPLRT_DIV) */
+	MPU6050_setDLPFMode(config->dlpf_mode);
+	gyro_rate = ((config->dlpf_mode == MPU6050_DLPF_BW_256) || (config->dlpf_mode > MPU6050_DLPF_BW_5)) ? 
+				GYRO_RATE_DLPF_OFF : GYRO_RATE_DLPF_ON;
+	divider = gyro_rate / config->sample_rate;
+	divider = (divider == 0) ? 1 : ((divider > 256) ? 256 : divider);
+	MPU6050_setRate(divider - 1);
+	mpu6050_fifo.period_us = (1000000UL * divider) / gyro_rate;
+	mpu6050_fifo.accel_scale = (1 << MPU6050_getFullScaleAccelRange()) / ACCEL_LSB_2G;
+	mpu6050_fifo.gyro_scale = (1 << MPU6050_getFullScaleGyroRange()) / GYRO_LSB_250;
+	if(mpu6050_fifo.task == NULL){
+		if(xTaskCreate(MPU6050_fifoTask, "mpu6050_fifo", MPU6050_FIFO_TASK_STACK, NULL, config->task_priority, &mpu6050_fifo.task) != pdPASS){
+			return false;
+		}
+		GPIOInit(config->int_pin, GPIO_INPUT);
+		GPIOActivInt(config->int_pin, MPU6050_fifoIsr, true, NULL);
+	}
+	/* INT: active high, push-pull, 50 us pulse on each new sample */
+	MPU6050_setInterruptMode(false);
+	MPU6050_setInterruptDrive(false);
+	MPU6050_setInterruptLatch(false);
+	/* Accel and gyro only (12 bytes per sample) */
+	MPU6050_resetFIFO();
+	MPU6050_setAccelFIFOEnabled(true);
+	MPU6050_setXGyroFIFOEnabled(true);
+	MPU6050_setYGyroFIFOEnabled(true);
+	MPU6050_setZGyroFIFOEnabled(true);
+	MPU6050_setFIFOEnabled(true);
+	MPU6050_setIntEnabled(1 << MPU6050_INTERRUPT_DATA_RDY_BIT);
+	return true;
+}
+
+void MPU6050_fifoStop(void){
+	MPU6050_setIntEnabled(0);
+	MPU6050_setFIFOEnabled(false);
+	MPU6050_setAccelFIFOEnabled(false);
+	MPU6050_setXGyroFIFOEnabled(false);
+	MPU6050_setYGyroFIFOEnabled(false);
+	MPU6050_setZGyroFIFOEnabled(false);
+}
+
+uint32_t MPU6050_fifoGetOverflowCount(void){
+	return mpu6050_fifo.overflows;
+}
+
+uint32_t MPU6050_fifoGetSamplePeriod(void){
+	return mpu6050_fifo.period_us;
+}
+
+void MPU6050_setDMPEnabled(bool enabled){
+    I2C_writeBit(devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_EN_BIT, enabled);
+}
+
+void MPU6050_resetDMP(void){
+    I2C_writeBit(devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_RESET_BIT, true);
+    /* Reset bit clears itself */
+    I2C_shadowInvalidate(devAddr, MPU6050_RA_USER_CTRL);
+}
+
+void MPU6050_setOTPBankValid(bool enabled){
+    I2C_writeBit(devAddr, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OTP_BNK_VLD_BIT, enabled);
+}
+
+void MPU6050_setMemoryBank(uint8_t bank, bool prefetchEnabled, bool userBank){
+    bank &= 0x1F;
+    if(userBank){
+    	bank |= 1 << MPU6050_BANKSEL_CFG_USER_BANK_BIT;
+    }
+    if(prefetchEnabled){
+    	bank |= 1 << MPU6050_BANKSEL_PRFTCH_EN_BIT;
+    }
+    I2C_writeByte(devAddr, MPU6050_RA_BANK_SEL, bank);
+}
+
+void MPU6050_setMemoryStartAddress(uint8_t address){
+    I2C_writeByte(devAddr, MPU6050_RA_MEM_START_ADDR, address);
+}
+
+/**
+ * @brief Bytes of a memory block that can be accessed in one transaction (a chunk can't cross a bank)
+ */
+static uint8_t MPU6050_memoryChunk(uint16_t remaining, uint8_t address){
+	uint16_t chunk = MPU6050_DMP_MEMORY_CHUNK_SIZE;
+	if(chunk > remaining){
+		chunk = remaining;
+	}
+	if(chunk > MPU6050_DMP_MEMORY_BANK_SIZE - address){
+		chunk = MPU6050_DMP_MEMORY_BANK_SIZE - address;
+	}
+	return chunk;
+}
+
+void MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address){
+	uint8_t chunk;
+	uint16_t i;
+	for(i = 0; i < dataSize; i += chunk){
+		MPU6050_setMemoryBank(bank, false, false);
+		MPU6050_setMemoryStartAddress(address);
+		chunk = MPU6050_memoryChunk(dataSize - i, address);
+		I2C_readBytesOnce(devAddr, MPU6050_RA_MEM_R_W, chunk, data + i, I2C_MASTER_TIMEOUT_MS);
+		address += chunk;
+		if(address == 0){
+			bank++;
+		}
+	}
+}
+
+bool MPU6050_writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify){
+	uint8_t chunk;
+	uint8_t check[MPU6050_DMP_MEMORY_CHUNK_SIZE];
+	uint16_t i;
+	bool ok = true;
+	for(i = 0; (i < dataSize) && ok; i += chunk){
+		MPU6050_setMemoryBank(bank, false, false);
+		MPU6050_setMemoryStartAddress(address);
+		chunk = MPU6050_memoryChunk(dataSize - i, address);
+		ok = I2C_writeBytes(devAddr, MPU6050_RA_MEM_R_W, chunk, (uint8_t *)(data + i));
+		if(ok && verify){
+			MPU6050_setMemoryBank(bank, false, false);
+			MPU6050_setMemoryStartAddress(address);
+			ok = (I2C_readBytesOnce(devAddr, MPU6050_RA_MEM_R_W, chunk, check, I2C_MASTER_TIMEOUT_MS) == chunk) && 
+				(memcmp(check, data + i, chunk) == 0);
+		}
+		address += chunk;
+		if(address == 0){
+			bank++;
+		}
+	}
+	/* MEM_R_W is a data port, not a register */
+	I2C_shadowInvalidate(devAddr, MPU6050_RA_MEM_R_W);
+	return ok;
+}
+
+#ifdef MPU6050_INCLUDE_DMP_MOTIONAPPS20
+bool MPU6050_dmpInitialize(const uint8_t *image, uint16_t size){
+	uint8_t rate_update[] = {0x00, MPU6050_DMP_FIFO_RATE_DIVISOR};
+	if((image == NULL) || (size != MPU6050_DMP_CODE_SIZE)){
+		return false;
+	}
+	MPU6050_reset();
+	vTaskDelay(pdMS_TO_TICKS(30));
+	MPU6050_setSleepEnabled(false);
+	/* The reset cleared the offset registers */
+	MPU6050_loadOffsets();
+	/* Auxiliary I2C master is not used */
+	MPU6050_setSlaveAddress(0, 0x7F);
+	MPU6050_setI2CMasterModeEnabled(false);
+	MPU6050_setSlaveAddress(0, 0x68);
+	MPU6050_resetI2CMaster();
+	vTaskDelay(pdMS_TO_TICKS(20));
+	MPU6050_setClockSource(MPU6050_CLOCK_PLL_ZGYRO);
+	MPU6050_setIntEnabled((1 << MPU6050_INTERRUPT_FIFO_OFLOW_BIT) | (1 << MPU6050_INTERRUPT_DMP_INT_BIT));
+	/* 1 kHz / (1 + 4) = 200 Hz */
+	MPU6050_setRate(4);
+	MPU6050_setExternalFrameSync(MPU6050_EXT_SYNC_TEMP_OUT_L);
+	MPU6050_setDLPFMode(MPU6050_DLPF_BW_42);
+	MPU6050_setFullScaleGyroRange(MPU6050_GYRO_FS_2000);
+	if(!MPU6050_writeMemoryBlock(image, size, 0, 0, true)){
+		return false;
+	}
+	/* FIFO rate divisor, bank 2 offset 0x16 of the firmware image */
+	MPU6050_writeMemoryBlock(rate_update, sizeof(rate_update), 0x02, 0x16, true);
+	I2C_writeByte(devAddr, MPU6050_RA_DMP_CFG_1, MPU6050_DMP_START_ADDRESS >> 8);
+	I2C_writeByte(devAddr, MPU6050_RA_DMP_CFG_2, MPU6050_DMP_START_ADDRESS & 0xFF);
+	MPU6050_setOTPBankValid(false);
+	MPU6050_setMotionDetectionThreshold(2);
+	MPU6050_setZeroMotionDetectionThreshold(156);
+	MPU6050_setMotionDetectionDuration(80);
+	MPU6050_setZeroMotionDetectionDuration(0);
+	MPU6050_setFIFOEnabled(true);
+	MPU6050_resetDMP();
+	MPU6050_setDMPEnabled(false);
+	MPU6050_resetFIFO();
+	MPU6050_getIntStatus();
+	return true;
+}
+
+bool MPU6050_dmpGetLatestPacket(uint8_t *packet){
+	uint16_t count = MPU6050_getFIFOCount();
+	if(count >= MPU6050_FIFO_SIZE){
+		MPU6050_resetFIFO();
+		return false;
+	}
+	if(count < MPU6050_DMP_PACKET_SIZE){
+		return false;
+	}
+	/* Older packets are discarded */
+	while(count >= MPU6050_DMP_PACKET_SIZE){
+		if(!MPU6050_getFIFOBytes(packet, MPU6050_DMP_PACKET_SIZE)){
+			MPU6050_resetFIFO();
+			return false;
+		}
+		count -= MPU6050_DMP_PACKET_SIZE;
+	}
+	return true;
+}
+
+void MPU6050_dmpGetQuaternion(float *q, const uint8_t *packet){
+	/* 32 bits per component, the upper 16 bits are in Q14 format */
+	for(uint8_t i = 0; i < 4; i++){
+		q[i] = MPU6050_toInt16((uint8_t *)&packet[4 * i]) / 16384.0f;
+	}
+	float norm = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	if(norm > 0.0f){
+		for(uint8_t i = 0; i < 4; i++){
+			q[i] /= norm;
+		}
+	}
+}
+
+void MPU6050_dmpGetAccel(int16_t *a, const uint8_t *packet){
+	a[0] = MPU6050_toInt16((uint8_t *)&packet[28]);
+	a[1] = MPU6050_toInt16((uint8_t *)&packet[32]);
+	a[2] = MPU6050_toInt16((uint8_t *)&packet[36]);
+}
+
+void MPU6050_dmpGetGyro(int16_t *g, const uint8_t *packet){
+	g[0] = MPU6050_toInt16((uint8_t *)&packet[16]);
+	g[1] = MPU6050_toInt16((uint8_t *)&packet[20]);
+	g[2] = MPU6050_toInt16((uint8_t *)&packet[24]);
+}
+
+void MPU6050_dmpGetGravity(float *v, const float *q){
+	v[0] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+	v[1] = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+	v[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+void MPU6050_dmpGetYawPitchRoll(float *ypr, const float *q, const float *gravity){
+	ypr[0] = atan2f(2.0f * q[1] * q[2] - 2.0f * q[0] * q[3], 2.0f * q[0] * q[0] + 2.0f * q[1] * q[1] - 1.0f);
+	ypr[1] = atan2f(gravity[0], sqrtf(gravity[1] * gravity[1] + gravity[2] * gravity[2]));
+	ypr[2] = atan2f(gravity[1], gravity[2]);
+}
+#endif
+
+/**
+ * @brief Read three consecutive 16 bits registers
+ */
+static void MPU6050_readOffsets(uint8_t regAddr, int16_t *offsets){
+	I2C_readBytes(devAddr, regAddr, 6, buffer, I2C_MASTER_TIMEOUT_MS);
+	for(uint8_t i = 0; i < 3; i++){
+		offsets[i] = MPU6050_toInt16(&buffer[2 * i]);
+	}
+}
+
+/**
+ * @brief Write three consecutive 16 bits registers
+ */
+static void MPU6050_writeOffsets(uint8_t regAddr, const int16_t *offsets){
+	uint8_t data[6];
+	for(uint8_t i = 0; i < 3; i++){
+		data[2 * i] = (uint16_t)offsets[i] >> 8;
+		data[2 * i + 1] = offsets[i] & 0xFF;
+	}
+	I2C_writeBytes(devAddr, regAddr, sizeof(data), data);
+}
+
+void MPU6050_getAccelOffsets(int16_t *offsets){
+	MPU6050_readOffsets(MPU6050_RA_XA_OFFS_H, offsets);
+}
+
+void MPU6050_setAccelOffsets(const int16_t *offsets){
+	int16_t current[3], value[3];
+	MPU6050_getAccelOffsets(current);
+	for(uint8_t i = 0; i < 3; i++){
+		value[i] = (offsets[i] & ~1) | (current[i] & 1);
+	}
+	MPU6050_writeOffsets(MPU6050_RA_XA_OFFS_H, value);
+}
+
+void MPU6050_getGyroOffsets(int16_t *offsets){
+	MPU6050_readOffsets(MPU6050_RA_XG_OFFS_USRH, offsets);
+}
+
+void MPU6050_setGyroOffsets(const int16_t *offsets){
+	MPU6050_writeOffsets(MPU6050_RA_XG_OFFS_USRH, offsets);
+}
+
+bool MPU6050_calibrate(uint16_t samples){
+	int16_t raw[6], low[6] = {0}, high[6] = {0};
+	int32_t sum[6];
+	int16_t accel_offs[3], gyro_offs[3], accel_orig[3], gyro_orig[3];
+	float accel_lsb, gyro_lsb;
+	bool still = true;
+	if(samples == 0){
+		samples = MPU6050_CALIB_SAMPLES;
+	}
+	accel_lsb = ACCEL_LSB_2G / (1 << MPU6050_getFullScaleAccelRange());
+	gyro_lsb = GYRO_LSB_250 / (1 << MPU6050_getFullScaleGyroRange());
+	MPU6050_getAccelOffsets(accel_orig);
+	MPU6050_getGyroOffsets(gyro_orig);
+	for(uint8_t pass = 0; (pass < MPU6050_CALIB_PASSES) && still; pass++){
+		memset(sum, 0, sizeof(sum));
+		for(uint16_t n = 0; n < samples; n++){
+			if(!MPU6050_getMotion6(&raw[0], &raw[1], &raw[2], &raw[3], &raw[4], &raw[5])){
+				still = false;
+				break;
+			}
+			for(uint8_t i = 0; i < 6; i++){
+				sum[i] += raw[i];
+				if((n == 0) || (raw[i] < low[i])){
+					low[i] = raw[i];
+				}
+				if((n == 0) || (raw[i] > high[i])){
+					high[i] = raw[i];
+				}
+			}
+			DelayUs(CALIB_SAMPLE_US);
+		}
+		/* Peak to peak spread of each axis: the device moved during the pass */
+		for(uint8_t i = 0; (i < 3) && still; i++){
+			still = (high[i] - low[i] <= MPU6050_CALIB_MAX_ACCEL_SPREAD * accel_lsb) &&
+					(high[i + 3] - low[i + 3] <= MPU6050_CALIB_MAX_GYRO_SPREAD * gyro_lsb);
+		}
+		if(!still){
+			break;
+		}
+		/* Z axis up: it must read +1 g */
+		sum[2] -= (int32_t)(accel_lsb * samples);
+		/* The residual error is subtracted from the offsets already in the registers */
+		MPU6050_getAccelOffsets(accel_offs);
+		MPU6050_getGyroOffsets(gyro_offs);
+		for(uint8_t i = 0; i < 3; i++){
+			accel_offs[i] -= lroundf(sum[i] * ACCEL_OFFS_LSB / (accel_lsb * samples));
+			gyro_offs[i] -= lroundf(sum[i + 3] * GYRO_OFFS_LSB / (gyro_lsb * samples));
+		}
+		MPU6050_setAccelOffsets(accel_offs);
+		MPU6050_setGyroOffsets(gyro_offs);
+	}
+	if(!still){
+		/* Do not leave the offsets of a partial calibration */
+		MPU6050_setAccelOffsets(accel_orig);
+		MPU6050_setGyroOffsets(gyro_orig);
+	}
+	return still;
+}
+
+bool MPU6050_saveOffsets(void){
+	int16_t offsets[6];
+	nvs_handle_t nvs;
+	esp_err_t rc;
+	MPU6050_getAccelOffsets(&offsets[0]);
+	MPU6050_getGyroOffsets(&offsets[3]);
+	if(nvs_open(MPU6050_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK){
+		return false;
+	}
+	rc = nvs_set_blob(nvs, MPU6050_NVS_KEY, offsets, sizeof(offsets));
+	if(rc == ESP_OK){
+		rc = nvs_commit(nvs);
+	}
+	nvs_close(nvs);
+	return rc == ESP_OK;
+}
+
+bool MPU6050_loadOffsets(void){
+	int16_t offsets[6];
+	size_t size = sizeof(offsets);
+	nvs_handle_t nvs;
+	esp_err_t rc;
+	if(nvs_open(MPU6050_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK){
+		return false;
+	}
+	rc = nvs_get_blob(nvs, MPU6050_NVS_KEY, offsets, &size);
+	nvs_close(nvs);
+	if((rc != ESP_OK) || (size != sizeof(offsets))){
+		return false;
+	}
+	MPU6050_setAccelOffsets(&offsets[0]);
+	MPU6050_setGyroOffsets(&offsets[3]);
+	return true;
+}
+
 /*==================[end of file]============================================*/
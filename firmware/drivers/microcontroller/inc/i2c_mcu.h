@@ -21,6 +21,11 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 30/01/2024 | Document creation		                         |
+ * | 19/10/2026 | i2c_master driver, single transaction reads    |
+ * | 19/10/2026 | Queued (asynchronous) transactions             |
+ * | 19/10/2026 | Register shadow cache for bit writes           |
+ * | 19/10/2026 | Bus scan, per device speed and retries         |
+ * | 19/10/2026 | Reads without retries (data ports)             |
  *
  */
 
@@ -28,11 +33,46 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_log.h"
-#include "driver/i2c.h"
+#include "driver/i2c_master.h"
 #include "gpio_mcu.h"
 /*==================[macros]=================================================*/
 
 /*==================[typedef]================================================*/
+/**
+ * @brief Queued transaction operation
+ */
+typedef enum {
+	I2C_OP_READ,		/*!< Read registers (repeated START) */
+	I2C_OP_WRITE,		/*!< Write registers */
+} i2c_op_t;
+
+/**
+ * @brief Queued transaction descriptor. It belongs to the caller and must remain valid
+ * until the transaction ends (done = true).
+ */
+typedef struct {
+	uint8_t devAddr;			/*!< I2C slave device address */
+	uint8_t regAddr;			/*!< First register address */
+	i2c_op_t op;				/*!< Operation */
+	uint8_t length;				/*!< Number of bytes to read or write */
+	uint8_t *data;				/*!< Data buffer */
+	void *func_p;				/*!< Pointer to callback function called (from the bus owner task) when the transaction ends (NULL if not required) */
+	void *param_p;				/*!< Pointer to callback parameter */
+	volatile bool done;			/*!< Set when the transaction ends (written by the driver) */
+	volatile bool ok;			/*!< Transaction result (written by the driver) */
+	int64_t submit_time;		/*!< Time the transaction was queued in us (written by the driver) */
+} i2c_transaction_t;
+
+/**
+ * @brief Per device counters of queued transactions
+ */
+typedef struct {
+	uint32_t transactions;		/*!< Transactions executed */
+	uint32_t errors;			/*!< Transactions failed */
+	uint32_t last_latency_us;	/*!< Time from queue to end of the last transaction */
+	uint32_t max_latency_us;	/*!< Maximum time from queue to end of a transaction */
+	uint64_t total_latency_us;	/*!< Sum of latencies (average = total_latency_us / transactions) */
+} i2c_dev_stats_t;
 #define I2C_MASTER_SCL_IO           GPIO_7      /*!< GPIO number used for I2C master clock */
 #define I2C_MASTER_SDA_IO           GPIO_6      /*!< GPIO number used for I2C master data  */
 #define I2C_MASTER_NUM              0           /*!< I2C master i2c port number, the number of i2c peripheral interfaces available will depend on the chip */
@@ -40,17 +80,32 @@
 #define I2C_MASTER_TX_BUF_DISABLE   0           /*!< I2C master doesn't need buffer */
 #define I2C_MASTER_RX_BUF_DISABLE   0           /*!< I2C master doesn't need buffer */
 #define I2C_MASTER_TIMEOUT_MS       1000
+#define I2C_MAX_DEVICES             8           /*!< Maximum number of slave addresses used on the bus */
+#define I2C_MAX_WRITE               32          /*!< Maximum number of data bytes in a single register write */
+#define I2C_QUEUE_TASK_STACK        2048        /*!< Stack size of the bus owner task */
+#define I2C_STANDARD_FREQ_HZ        100000      /*!< Standard-mode SCL frequency */
+#define I2C_FAST_FREQ_HZ            400000      /*!< Fast-mode SCL frequency */
+#define I2C_FAST_PLUS_FREQ_HZ       1000000     /*!< Fast-mode Plus SCL frequency */
+#define I2C_MCU_MAX_FREQ_HZ         800000      /*!< Maximum SCL frequency of the ESP32-C6 I2C master (needs strong pull-ups) */
+#define I2C_SCAN_FIRST_ADDR         0x08        /*!< First non reserved 7 bits address */
+#define I2C_SCAN_LAST_ADDR          0x77        /*!< Last non reserved 7 bits address */
+#define I2C_SCAN_TIMEOUT_MS         10          /*!< Timeout of each address probe */
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
 
 /** @fn I2C_initialize( uint32_t clockRateHz )
  * @brief Initialize I2C0
+ * @note Slave devices are added to the bus the first time they are accessed.
+ * @param clockRateHz SCL frequency
+ * @return true if the bus was initialized
  */
 bool I2C_initialize( uint32_t clockRateHz );
 
 /** @fn I2C_enable(bool isEnabled)
  * @brief Enable or disable I2C
+ * @note Disabling the bus removes the device handles and releases the port pins. Device 
+ * settings, register caches and counters are kept.
  * @param isEnabled true = enable, false = disable
  */
 void I2C_enable(bool isEnabled);
@@ -61,7 +116,7 @@ void I2C_enable(bool isEnabled);
  * @param regAddr Register regAddr to read from
  * @param bitNum Bit position to read (0-7)
  * @param data Container for single bit value
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
  * @return Status of read operation (true = success)
  */
 int8_t I2C_readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout);
@@ -73,7 +128,7 @@ int8_t I2C_readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *da
  * @param bitStart First bit position to read (0-7)
  * @param length Number of bits to read (not more than 8)
  * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
  * @return Status of read operation (true = success)
  */
 int8_t I2C_readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data, uint16_t timeout);
@@ -83,7 +138,7 @@ int8_t I2C_readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t
  * @param devAddr I2C slave device address
  * @param regAddr Register regAddr to read from
  * @param data Container for byte value read from device
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
  * @return Status of read operation (true = success)
  */
 int8_t I2C_readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout);
@@ -100,14 +155,29 @@ int8_t I2C_readWord(uint8_t devAddr, uint8_t regAddr, uint16_t *data, uint16_t t
 
 /** @fn I2C_readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout)
  * @brief Read multiple bytes from an 8-bit device register.
+ * @note The count is returned as int16_t: reads of 128 to 255 bytes are positive.
+ * @note The register address write and the data read are done in a single transaction (repeated START).
+ * @param devAddr I2C slave device address
+ * @param regAddr First register regAddr to read from
+ * @param length Number of bytes to read
+ * @param data Buffer to store read data in
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
+ * @return Number of bytes read (0 on error)
+ */
+int16_t I2C_readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout);
+
+/** @fn I2C_readBytesOnce(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout)
+ * @brief Read multiple bytes from an 8-bit device register without retries.
+ * @note For data ports (FIFOs) that advance with every byte clocked out: a retry after a 
+ * partial transfer would read from a shifted position and succeed.
  * @param devAddr I2C slave device address
  * @param regAddr First register regAddr to read from
  * @param length Number of bytes to read
  * @param data Buffer to store read data in
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
- * @return I2C_TransferReturn_TypeDef
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
+ * @return Number of bytes read (0 on error)
  */
-int8_t I2C_readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout);
+int16_t I2C_readBytesOnce(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout);
 
 /** @fn I2C_writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data);
  * @brief write a single bit in an 8-bit device register.
@@ -149,7 +219,7 @@ bool I2C_writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data);
 bool I2C_writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data);
 
 /** @fn I2C_writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data)
- * @brief Write multiple bytes to device.
+ * @brief Write multiple bytes to device (up to I2C_MAX_WRITE).
  * @param devAddr I2C slave device address
  * @param regAddr Register address to write to
  * @param length Number of bytes to write
@@ -165,6 +235,108 @@ bool I2C_writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *d
  */
 void I2C_SelectRegister(uint8_t devAddr, uint8_t reg);
 
+/** @fn I2C_scan(uint8_t *found, uint8_t max)
+ * @brief Probe every non reserved address (0x08 to 0x77) and mark the devices that answer as 
+ * present on the bus
+ * @note Call it at startup, before any other task uses the bus.
+ * @param found Buffer for the addresses found (NULL if not required)
+ * @param max Size of found buffer
+ * @return Number of devices that answered (could be greater than max)
+ */
+uint8_t I2C_scan(uint8_t *found, uint8_t max);
+
+/** @fn I2C_setDeviceSpeed(uint8_t devAddr, uint32_t maxClockHz, uint8_t retries)
+ * @brief Set the maximum SCL frequency supported by a device and the number of retries after a 
+ * failed transfer. The device is considered present on the bus.
+ * @note Devices without this setting are assumed to support Fast-mode (I2C_FAST_FREQ_HZ) with no retries.
+ * @param devAddr I2C slave device address
+ * @param maxClockHz Maximum SCL frequency (I2C_STANDARD_FREQ_HZ, I2C_FAST_FREQ_HZ, I2C_FAST_PLUS_FREQ_HZ)
+ * @param retries Retries after a failed transfer
+ * @return true if the device could be registered
+ */
+bool I2C_setDeviceSpeed(uint8_t devAddr, uint32_t maxClockHz, uint8_t retries);
+
+/** @fn I2C_negotiateSpeed(void)
+ * @brief Set the bus clock to the highest frequency supported by every present device 
+ * (up to I2C_MCU_MAX_FREQ_HZ)
+ * @note The bus must be idle (no queued transactions) while the clock is changed.
+ * @return Bus SCL frequency
+ */
+uint32_t I2C_negotiateSpeed(void);
+
+/** @fn I2C_getClock(void)
+ * @brief Current bus SCL frequency
+ * @return SCL frequency in Hz
+ */
+uint32_t I2C_getClock(void);
+
+/** @fn I2C_shadowEnable(uint8_t devAddr)
+ * @brief Enable the register shadow cache of a device
+ * @note Once enabled, I2C_writeBit and I2C_writeBits take the current register value from the 
+ * cache instead of reading it from the bus, so a bit-field update is a single write. The cache 
+ * is write-through and filled lazily: the first bit update of a register reads it from the bus.
+ * Registers whose bits are changed by the device itself (e.g. self-clearing reset bits) must be 
+ * invalidated after writing them.
+ * @param devAddr I2C slave device address
+ * @return true if the cache was enabled
+ */
+bool I2C_shadowEnable(uint8_t devAddr);
+
+/** @fn I2C_shadowInvalidate(uint8_t devAddr, uint8_t regAddr)
+ * @brief Discard the cached value of a register (next bit update reads it from the bus)
+ * @param devAddr I2C slave device address
+ * @param regAddr Register address
+ */
+void I2C_shadowInvalidate(uint8_t devAddr, uint8_t regAddr);
+
+/** @fn I2C_shadowInvalidateAll(uint8_t devAddr)
+ * @brief Discard every cached register of a device (e.g. after a device reset)
+ * @param devAddr I2C slave device address
+ */
+void I2C_shadowInvalidateAll(uint8_t devAddr);
+
+/** @fn I2C_shadowRefresh(uint8_t devAddr, uint8_t regAddr, uint8_t length)
+ * @brief Read a block of registers from the device and store them in the cache
+ * @note The block is read in transactions of up to 32 registers, up to the last register address.
+ * @param devAddr I2C slave device address
+ * @param regAddr First register address
+ * @param length Number of registers (at least 1)
+ * @return true if the registers were read (false if length is 0)
+ */
+bool I2C_shadowRefresh(uint8_t devAddr, uint8_t regAddr, uint8_t length);
+
+/** @fn I2C_queueInit(uint8_t queue_size, uint8_t priority)
+ * @brief Create the transaction queue and the task that owns the bus and executes the
+ * queued transactions back-to-back.
+ * @note Blocking functions can still be used from any task, the driver serializes the bus access.
+ * @param queue_size Maximum number of transactions waiting in the queue
+ * @param priority Priority of the bus owner task
+ * @return true if the queue and task were created
+ */
+bool I2C_queueInit(uint8_t queue_size, uint8_t priority);
+
+/** @fn I2C_queueSubmit(i2c_transaction_t *transaction, uint32_t timeout_ms)
+ * @brief Queue a transaction and return without waiting for it to be executed
+ * @param transaction Transaction descriptor (must remain valid until transaction->done is true)
+ * @param timeout_ms Maximum time to wait for room in the queue (0: don't wait)
+ * @return true if the transaction was queued
+ */
+bool I2C_queueSubmit(i2c_transaction_t *transaction, uint32_t timeout_ms);
+
+/** @fn I2C_getStats(uint8_t devAddr, i2c_dev_stats_t *stats)
+ * @brief Get the counters of the transactions queued for a device
+ * @param devAddr I2C slave device address
+ * @param stats Structure where counters are copied (consistent snapshot, taken in a critical section)
+ * @return true if the device is known
+ */
+bool I2C_getStats(uint8_t devAddr, i2c_dev_stats_t *stats);
+
+/** @fn I2C_resetStats(uint8_t devAddr)
+ * @brief Clear the transaction counters of a device
+ * @param devAddr I2C slave device address
+ */
+void I2C_resetStats(uint8_t devAddr);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -21,12 +21,20 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 09/02/2024 | Document creation		                         						|
+ * | 19/10/2026 | Queued (asynchronous) transactions	           						|
+ * | 19/10/2026 | Devices are registered once (duplicated SpiInit is rejected)			|
+ * | 19/10/2026 | Burst mode (bus acquired for a sequence of transactions)				|
+ * | 19/10/2026 | Transfers of any size and DMA capable buffer allocation				|
  * 
  **/
 /*==================[inclusions]=============================================*/
 #include <stdbool.h>
 #include <stdint.h>
 /*==================[macros]=================================================*/
+#define SPI_QUEUE_SIZE		8			/*!< Maximum number of queued transactions for each device */
+#define SPI_WAIT_FOREVER	0xFFFFFFFF	/*!< Timeout value to wait until the transaction ends */
+#define SPI_MAX_CHUNK_SIZE	(4092 * 4)	/*!< Maximum size of a single DMA transaction. Blocking transfers 
+											bigger than this are split automatically */
 
 /*==================[typedef]================================================*/
 
@@ -68,6 +76,8 @@ typedef struct{
 	transfer_mode_t transfer_mode;	/*!< Transfer mode */
 	void *func_p;					/*!< Pointer to callback function for transaction end */
 	void *param_p;					/*!< Pointer to callback parameter */
+	void *pre_func_p;				/*!< Pointer to callback function called before each burst transaction starts 
+										(receives the parameter given to SpiBurstWrite, NULL if not required) */
 } spi_mcu_config_t;
 /*==================[external data declaration]==============================*/
 
@@ -75,14 +85,27 @@ typedef struct{
 /**
  * @brief Initialize SPI module with the corresponding configuration
  * 
+ * @note The device is added to the bus only once and keeps its handle. Calling 
+ * SpiInit again for the same device fails until SpiDeInit is called.
+ * 
  * @param spi Structure with the module configuration
- * @return uint8_t 
+ * @return uint8_t true if the device was registered, false if it was already registered or on error
  */
 uint8_t SpiInit(spi_mcu_config_t* spi);
 
+/**
+ * @brief Check if a device was already registered with SpiInit
+ * 
+ * @param device SPI device
+ * @return true if the device is registered
+ */
+bool SpiIsInitialized(spi_dev_t device);
+
 /**
  * @brief Read data from SPI port
  * 
+ * @note Buffers of any size are accepted (see SpiWrite).
+ * 
  * @param device SPI device to read from
  * @param rx_buffer pointer to buffer where data is stored
  * @param rx_buffer_size numbers of bytes to read
@@ -92,6 +115,11 @@ void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size);
 /**
  * @brief Write data from SPI port
  * 
+ * @note Buffers of any size are accepted: transfers bigger than SPI_MAX_CHUNK_SIZE are split
+ * in chunks that are queued back-to-back. Data that DMA can't reach (e.g. constants stored 
+ * in flash) is copied through internal DMA buffers while the previous chunk is being sent. 
+ * Use SpiDmaMalloc for big buffers to avoid that copy.
+ * 
  * @param device SPI device to read from
  * @param tx_buffer pointer to buffer where data is stored
  * @param tx_buffer_size numbers of bytes to write
@@ -108,11 +136,127 @@ void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size);
  */
 void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size);
 
+/**
+ * @brief Queue a write transaction and return without waiting for it to end
+ * 
+ * @note Transactions are taken from a pre-allocated pool of SPI_QUEUE_SIZE elements per device.
+ * If the pool is full, the function waits for the oldest transaction to end and releases it.
+ * tx_buffer must remain valid (and unmodified) until the transaction ends.
+ * 
+ * @note Blocking functions (SpiRead, SpiWrite, SpiReadWrite) wait for every queued 
+ * transaction of the device to end before starting.
+ * 
+ * @param device SPI device to write to
+ * @param tx_buffer pointer to buffer where data is stored
+ * @param tx_buffer_size numbers of bytes to write
+ * @param func_p Pointer to callback function called (from ISR) when the transaction ends (NULL if not required)
+ * @param param_p Pointer to callback parameter
+ * @return uint8_t true if the transaction was queued
+ */
+uint8_t SpiQueueWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size, void *func_p, void *param_p);
+
+/**
+ * @brief Queue a read transaction and return without waiting for it to end
+ * 
+ * @note rx_buffer content is valid once the callback is called or SpiGetResult returns it.
+ * 
+ * @param device SPI device to read from
+ * @param rx_buffer pointer to buffer where data is stored
+ * @param rx_buffer_size numbers of bytes to read
+ * @param func_p Pointer to callback function called (from ISR) when the transaction ends (NULL if not required)
+ * @param param_p Pointer to callback parameter
+ * @return uint8_t true if the transaction was queued
+ */
+uint8_t SpiQueueRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size, void *func_p, void *param_p);
+
+/**
+ * @brief Queue a simultaneous write and read transaction and return without waiting for it to end
+ * 
+ * @param device SPI device
+ * @param tx_buffer pointer to buffer where data to write is stored
+ * @param rx_buffer pointer to buffer where data read is stored
+ * @param buffer_size numbers of bytes to read or write
+ * @param func_p Pointer to callback function called (from ISR) when the transaction ends (NULL if not required)
+ * @param param_p Pointer to callback parameter
+ * @return uint8_t true if the transaction was queued
+ */
+uint8_t SpiQueueReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size, void *func_p, void *param_p);
+
+/**
+ * @brief Wait for the oldest queued transaction of a device to end and release it
+ * 
+ * @param device SPI device
+ * @param buffer pointer where the address of the transaction buffer (rx buffer if any, tx buffer otherwise) 
+ * is stored (NULL if not required)
+ * @param timeout_ms maximum time to wait in milliseconds (0: don't wait, SPI_WAIT_FOREVER: no timeout)
+ * @return uint8_t true if a transaction ended, false if there are no queued transactions or timeout expired
+ */
+uint8_t SpiGetResult(spi_dev_t device, uint8_t ** buffer, uint32_t timeout_ms);
+
+/**
+ * @brief Get the number of queued transactions whose result was not retrieved yet
+ * 
+ * @param device SPI device
+ * @return uint8_t Number of transactions
+ */
+uint8_t SpiQueuePending(spi_dev_t device);
+
+/**
+ * @brief Acquire the SPI bus for a sequence of transactions of a device
+ * 
+ * @note While the bus is acquired other devices can't use it, and transactions of this 
+ * device go out back-to-back without the per-transaction locking of the driver.
+ * Calls can be nested, the bus is released by the last SpiBurstEnd().
+ * 
+ * @param device SPI device
+ * @return uint8_t true if the bus was acquired
+ */
+uint8_t SpiBurstBegin(spi_dev_t device);
+
+/**
+ * @brief Write data inside a burst (between SpiBurstBegin and SpiBurstEnd)
+ * 
+ * @note Before the transaction starts the device pre_func_p callback is called with
+ * pre_param_p (e.g. to drive a data/command pin). Transfers up to 4 bytes are sent 
+ * without using DMA, bigger ones can be of any size (see SpiWrite).
+ * 
+ * @param device SPI device to write to
+ * @param tx_buffer pointer to buffer where data is stored
+ * @param tx_buffer_size numbers of bytes to write
+ * @param pre_param_p parameter passed to the pre-transaction callback
+ * @return uint8_t false if a short transfer failed
+ */
+uint8_t SpiBurstWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size, void *pre_param_p);
+
+/**
+ * @brief Release the SPI bus acquired with SpiBurstBegin
+ * 
+ * @param device SPI device
+ */
+void SpiBurstEnd(spi_dev_t device);
+
+/**
+ * @brief Allocate a buffer that SPI DMA can access directly (internal RAM, word aligned)
+ * 
+ * @param size Buffer size in bytes
+ * @return uint8_t* Pointer to the buffer (NULL if there is not enough memory)
+ */
+uint8_t * SpiDmaMalloc(uint32_t size);
+
+/**
+ * @brief Free a buffer allocated with SpiDmaMalloc
+ * 
+ * @param buffer Pointer to the buffer
+ */
+void SpiDmaFree(uint8_t * buffer);
+
 /**
  * @brief De-Initialize SPI module with the corresponding configuration
  * 
+ * @note Waits for queued transactions to end and removes the device from the bus.
+ * 
  * @param device SPI device 
- * @return uint8_t 
+ * @return uint8_t true if the device was removed
  */
 uint8_t SpiDeInit(spi_dev_t device);
 
@@ -17,13 +17,17 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 02/07/2024 | Document creation		                         						|
+ * | 19/10/2026 | Configurable buffers, flow control and event task						|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include "stdint.h"
+#include "stdbool.h"
+#include "gpio_mcu.h"
 /*==================[macros]=================================================*/
 #define UART_NO_INT	0		/*!< Flag used when no reading interruption is required */
+#define UART_MAX_BAUD_RATE	5000000	/*!< Maximum baud rate supported by ESP32-C6 UART (bits per second) */
 /*==================[typedef]================================================*/
 /**
  * @brief List of UART ports available in ESP-EDU
@@ -40,6 +44,14 @@ typedef struct {
 	uint32_t baud_rate;		/*!< baudrate (bits per second) */
 	void *func_p;			/*!< Pointer to callback function to call when receiving data (= UART_NO_INT if not requiered)*/
 	void *param_p;			/*!< Pointer to callback function parameters */
+	uint16_t rx_buffer_size;	/*!< RX ring buffer size in bytes (0: default 256, must be greater than 128) */
+	uint16_t tx_buffer_size;	/*!< TX ring buffer size in bytes (0: default 256, must be greater than 128) */
+	uint8_t event_queue_size;	/*!< UART event queue length (0: default 16) */
+	bool hw_flow_ctrl;			/*!< Enable RTS/CTS hardware flow control */
+	gpio_t rts_pin;				/*!< RTS pin (only used if hw_flow_ctrl = true) */
+	gpio_t cts_pin;				/*!< CTS pin (only used if hw_flow_ctrl = true) */
+	uint8_t task_priority;		/*!< Priority of the event task that calls func_p (0: default 12) */
+	uint16_t task_stack_size;	/*!< Stack size of the event task that calls func_p (0: default 2048) */
 } serial_config_t;
 /*==================[external data declaration]==============================*/
 
@@ -47,9 +59,24 @@ typedef struct {
 /**
  * @brief Serial port initialization
  * 
+ * @note Fields added after param_p can be left at 0 to keep the default values.
+ * After configuring the port the effective baud rate is read back from the 
+ * peripheral and compared against the requested one (tolerance 2%).
+ * 
  * @param port_config 
+ * @return uint8_t true if the port was configured at the requested baud rate, false otherwise
+ */
+uint8_t UartInit(serial_config_t *port_config);
+
+/**
+ * @brief Get the number of RX FIFO / ring buffer overflows since initialization
+ * 
+ * @note Overflows are only detected when a reception callback is configured (func_p != UART_NO_INT).
+ * 
+ * @param port Port to query
+ * @return uint32_t Number of overflows
  */
-void UartInit(serial_config_t *port_config);
+uint32_t UartGetOverflowCount(uart_mcu_port_t port);
 
 /**
  * @brief Read a single byte from serial port
@@ -82,6 +109,7 @@ void UartSendByte(uart_mcu_port_t port, const char *data);
  * @brief Send a String trough serial port
  * 
  * @note Sends data untill finding the '\0' character (used to indicate a String end).
+ * If the TX buffer is full it waits until there is room for the whole string.
  * 
  * @param port Port for sending data
  * @param msg Pointer to string to be transmitted
@@ -95,7 +123,7 @@ void UartSendString(uart_mcu_port_t port, const char *msg);
  * @param data Pointer to array of data to be transmitted
  * @param nbytes Number of bytes to be sended
  */
-void UartSendBuffer(uart_mcu_port_t port, const char *data, uint8_t nbytes);
+void UartSendBuffer(uart_mcu_port_t port, const char *data, uint16_t nbytes);
 
 /**
  * @brief Convert a number to a String (char array ended with '\0')
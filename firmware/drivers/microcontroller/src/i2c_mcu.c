@@ -14,40 +14,280 @@
 #include <esp_err.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+#include <string.h>
+#include <stdlib.h>
 //#include "sdkconfig.h"
 
 #include "i2c_mcu.h"
 /*==================[macros and definitions]=================================*/
 #define I2C_NUM I2C_NUM_0
+#define I2C_GLITCH_COUNT	7			/*!< Glitch filter (in I2C source clock cycles) */
+#define I2C_REG_QTY			256			/*!< Number of 8 bits register addresses */
+#define I2C_SHADOW_CHUNK	32			/*!< Registers read per transaction by I2C_shadowRefresh() */
 
 #undef ESP_ERROR_CHECK
 #define ESP_ERROR_CHECK(x)   do { esp_err_t rc = (x); if (rc != ESP_OK) { ESP_LOGE("err", "esp_err_t = %d", rc); /*assert(0 && #x);*/} } while(0);
 
 /*==================[internal data definition]===============================*/
-
+/**
+ * @brief Device attached to the bus (the i2c_master driver needs a handle per slave address)
+ */
+typedef struct {
+	uint8_t addr;						/*!< 7 bits slave address */
+	i2c_master_dev_handle_t handle;		/*!< Device handle */
+	i2c_dev_stats_t stats;				/*!< Queued transactions counters */
+	uint8_t *shadow;					/*!< Register cache (NULL if disabled) */
+	uint32_t shadow_valid[I2C_REG_QTY / 32];	/*!< One bit for each cached register */
+	uint32_t max_clock;					/*!< Maximum SCL frequency supported by the device */
+	uint8_t retries;					/*!< Retries after a failed transfer */
+	bool present;						/*!< The device answered a bus scan */
+} i2c_device_t;
+
+static i2c_master_bus_handle_t i2c_bus = NULL;		/*!< Bus handle */
+static uint32_t i2c_clock = I2C_MASTER_FREQ_HZ;		/*!< Clock used for new devices */
+static i2c_master_bus_config_t i2c_bus_cfg = {		/*!< Bus configuration (kept to enable the bus again) */
+	.i2c_port = I2C_MASTER_NUM,
+	.sda_io_num = I2C_MASTER_SDA_IO,
+	.scl_io_num = I2C_MASTER_SCL_IO,
+	.clk_source = I2C_CLK_SRC_DEFAULT,
+	.glitch_ignore_cnt = I2C_GLITCH_COUNT,
+	.flags.enable_internal_pullup = true,
+};
+static i2c_device_t i2c_devices[I2C_MAX_DEVICES];	/*!< Devices added to the bus */
+static uint8_t i2c_device_count = 0;				/*!< Number of devices added to the bus */
+static portMUX_TYPE i2c_table_lock = portMUX_INITIALIZER_UNLOCKED;	/*!< Device records and counters */
+static SemaphoreHandle_t i2c_handle_mutex = NULL;	/*!< Device handles and register caches (blocking driver calls) */
+static StaticSemaphore_t i2c_handle_mutex_buffer;
+static QueueHandle_t i2c_queue = NULL;				/*!< Queued transactions */
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief Search a device in i2c_devices, i2c_table_lock must be held
+ */
+static uint8_t I2C_findDevice(uint8_t devAddr){
+	uint8_t i;
+	for(i = 0; i < i2c_device_count; i++){
+		if(i2c_devices[i].addr == devAddr){
+			break;
+		}
+	}
+	return (i < i2c_device_count) ? i : I2C_MAX_DEVICES;
+}
 
-/*==================[external functions definition]==========================*/
+/**
+ * @brief Get the index of a device in i2c_devices (I2C_MAX_DEVICES if it wasn't used yet)
+ * @note Records are never removed, so the index stays valid after the lock is released
+ */
+static uint8_t I2C_deviceIndex(uint8_t devAddr){
+	uint8_t idx;
+	taskENTER_CRITICAL(&i2c_table_lock);
+	idx = I2C_findDevice(devAddr);
+	taskEXIT_CRITICAL(&i2c_table_lock);
+	return idx;
+}
 
-/** Initialize I2C0
+/**
+ * @brief Get the record of a device, creating it the first time it is used (NULL if the table is full)
+ *
+ * Lookup and creation are done in one critical section: two tasks registering the same or
+ * different devices never share a slot, and a record is counted only once it is initialized.
  */
-bool I2C_initialize( uint32_t clockRateHz )
-{
-	int i2c_master_port = I2C_MASTER_NUM;
+static i2c_device_t * I2C_deviceEntry(uint8_t devAddr){
+	i2c_device_t *dev = NULL;
+	uint8_t idx;
+	taskENTER_CRITICAL(&i2c_table_lock);
+	idx = I2C_findDevice(devAddr);
+	if(idx < I2C_MAX_DEVICES){
+		dev = &i2c_devices[idx];
+	} else if(i2c_device_count < I2C_MAX_DEVICES){
+		dev = &i2c_devices[i2c_device_count];
+		memset(dev, 0, sizeof(i2c_device_t));
+		dev->addr = devAddr;
+		dev->max_clock = I2C_MASTER_FREQ_HZ;
+		i2c_device_count++;
+	}
+	taskEXIT_CRITICAL(&i2c_table_lock);
+	return dev;
+}
+
+/**
+ * @brief Create the mutex of the device handles (before the bus is created)
+ */
+static void I2C_lockInit(void){
+	if(i2c_handle_mutex == NULL){
+		i2c_handle_mutex = xSemaphoreCreateMutexStatic(&i2c_handle_mutex_buffer);
+	}
+}
+
+/**
+ * @brief Get the handle of a device, adding it to the bus (at the current bus clock) if needed
+ */
+static i2c_master_dev_handle_t I2C_device(uint8_t devAddr){
+	i2c_device_config_t dev_cfg = {
+		.dev_addr_length = I2C_ADDR_BIT_LEN_7,
+		.device_address = devAddr,
+		.scl_speed_hz = i2c_clock,
+	};
+	i2c_device_t *dev;
+	if(i2c_bus == NULL){
+		return NULL;
+	}
+	dev = I2C_deviceEntry(devAddr);
+	if(dev == NULL){
+		return NULL;
+	}
+	if(dev->handle == NULL){
+		/* Only one task adds the handle of a device */
+		xSemaphoreTake(i2c_handle_mutex, portMAX_DELAY);
+		if(dev->handle == NULL){
+			if(i2c_master_bus_add_device(i2c_bus, &dev_cfg, &dev->handle) != ESP_OK){
+				dev->handle = NULL;
+			} else {
+				/* Devices in use limit the bus clock even if they were not scanned */
+				dev->present = true;
+			}
+		}
+		xSemaphoreGive(i2c_handle_mutex);
+	}
+	return dev->handle;
+}
+
+/**
+ * @brief Remove all device handles from the bus (records, caches and counters are kept)
+ */
+static void I2C_detachAll(void){
+	xSemaphoreTake(i2c_handle_mutex, portMAX_DELAY);
+	for(uint8_t i = 0; i < i2c_device_count; i++){
+		if(i2c_devices[i].handle != NULL){
+			i2c_master_bus_rm_device(i2c_devices[i].handle);
+			i2c_devices[i].handle = NULL;
+		}
+	}
+	xSemaphoreGive(i2c_handle_mutex);
+}
 
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = clockRateHz,
-    };
+/**
+ * @brief Number of retries configured for a device
+ */
+static uint8_t I2C_retries(uint8_t devAddr){
+	uint8_t idx = I2C_deviceIndex(devAddr);
+	return (idx < I2C_MAX_DEVICES) ? i2c_devices[idx].retries : 0;
+}
 
-    i2c_param_config(i2c_master_port, &conf);
+/**
+ * @brief Get the register cache of a device (NULL if the cache is disabled)
+ */
+static i2c_device_t * I2C_shadow(uint8_t devAddr){
+	uint8_t idx = I2C_deviceIndex(devAddr);
+	if((idx == I2C_MAX_DEVICES) || (i2c_devices[idx].shadow == NULL)){
+		return NULL;
+	}
+	return &i2c_devices[idx];
+}
+
+/**
+ * @brief Store a register value in the cache
+ */
+static void I2C_shadowStore(i2c_device_t *dev, uint8_t regAddr, uint8_t data){
+	dev->shadow[regAddr] = data;
+	dev->shadow_valid[regAddr / 32] |= (1UL << (regAddr % 32));
+}
 
-    return i2c_driver_install(i2c_master_port, conf.mode, I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE, 0);
+/**
+ * @brief Current value of a register: from the cache if valid, from the bus otherwise
+ */
+static bool I2C_readCurrent(uint8_t devAddr, uint8_t regAddr, uint8_t *data){
+	i2c_device_t *dev = I2C_shadow(devAddr);
+	if((dev != NULL) && (dev->shadow_valid[regAddr / 32] & (1UL << (regAddr % 32)))){
+		*data = dev->shadow[regAddr];
+		return true;
+	}
+	if(I2C_readByte(devAddr, regAddr, data, 0) == 0){
+		return false;
+	}
+	if(dev != NULL){
+		I2C_shadowStore(dev, regAddr, *data);
+	}
 	return true;
+}
+
+/**
+ * @brief Bus owner task: executes queued transactions in order
+ */
+static void I2C_queueTask(void *pvParameters){
+	i2c_transaction_t *t;
+	uint32_t latency;
+	uint8_t idx;
+	while(1){
+		if(xQueueReceive(i2c_queue, &t, portMAX_DELAY) == pdTRUE){
+			if(t->op == I2C_OP_READ){
+				t->ok = (I2C_readBytes(t->devAddr, t->regAddr, t->length, t->data, 0) == (int16_t)t->length);
+			} else {
+				t->ok = I2C_writeBytes(t->devAddr, t->regAddr, t->length, t->data);
+			}
+			latency = esp_timer_get_time() - t->submit_time;
+			idx = I2C_deviceIndex(t->devAddr);
+			if(idx < I2C_MAX_DEVICES){
+				/* Updated as a whole: I2C_getStats() never sees half of an update */
+				taskENTER_CRITICAL(&i2c_table_lock);
+				i2c_dev_stats_t *stats = &i2c_devices[idx].stats;
+				stats->transactions++;
+				if(!t->ok){
+					stats->errors++;
+				}
+				stats->last_latency_us = latency;
+				stats->total_latency_us += latency;
+				if(latency > stats->max_latency_us){
+					stats->max_latency_us = latency;
+				}
+				taskEXIT_CRITICAL(&i2c_table_lock);
+			}
+			t->done = true;
+			if(t->func_p != NULL){
+				((void (*)(void*))t->func_p)(t->param_p);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Convert the timeout argument (0: default) to the driver timeout
+ */
+static int I2C_timeout(uint16_t timeout){
+	return (timeout == 0) ? I2C_MASTER_TIMEOUT_MS : timeout;
+}
+
+/**
+ * @brief Read transaction, repeated up to retries times after a failure
+ */
+static int16_t I2C_read(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout, uint8_t retries){
+	i2c_master_dev_handle_t dev = I2C_device(devAddr);
+	if(dev == NULL){
+		return 0;
+	}
+	/* START, address + W, register, repeated START, address + R, data, STOP: one single transaction */
+	esp_err_t rc;
+	do{
+		rc = i2c_master_transmit_receive(dev, &regAddr, 1, data, length, I2C_timeout(timeout));
+	} while((rc != ESP_OK) && (retries-- > 0));
+	ESP_ERROR_CHECK(rc);
+	return (rc == ESP_OK) ? length : 0;
+}
+
+/*==================[external functions definition]==========================*/
+
+/** Initialize I2C0
+ */
+bool I2C_initialize( uint32_t clockRateHz )
+{
+	i2c_clock = clockRateHz;
+	I2C_lockInit();
+	if(i2c_bus != NULL){
+		return true;
+	}
+	return i2c_new_master_bus(&i2c_bus_cfg, &i2c_bus) == ESP_OK;
 };
 
 
@@ -56,7 +296,17 @@ bool I2C_initialize( uint32_t clockRateHz )
  * @param isEnabled true = enable, false = disable
  */
 void I2C_enable(bool isEnabled) {
-  
+	if(isEnabled){
+		/* Device handles are added again the next time each device is accessed */
+		if(i2c_bus == NULL){
+			I2C_lockInit();
+			ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_bus_cfg, &i2c_bus));
+		}
+	} else if(i2c_bus != NULL){
+		I2C_detachAll();
+		ESP_ERROR_CHECK(i2c_del_master_bus(i2c_bus));
+		i2c_bus = NULL;
+	}
 }
 
 /** Default timeout value for read operations.
@@ -67,7 +317,7 @@ void I2C_enable(bool isEnabled) {
  * @param regAddr Register regAddr to read from
  * @param bitNum Bit position to read (0-7)
  * @param data Container for single bit value
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
  * @return Status of read operation (true = success)
  */
 int8_t I2C_readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout) {
@@ -85,7 +335,7 @@ int8_t I2C_readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *da
  * @param bitStart First bit position to read (0-7)
  * @param length Number of bits to read (not more than 8)
  * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
  * @return Status of read operation (true = success)
  */
 int8_t I2C_readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data, uint16_t timeout) {
@@ -108,7 +358,7 @@ int8_t I2C_readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t
  * @param devAddr I2C slave device address
  * @param regAddr Register regAddr to read from
  * @param data Container for byte value read from device
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
  * @return Status of read operation (true = success)
  */
 int8_t I2C_readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout) {
@@ -120,46 +370,32 @@ int8_t I2C_readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t ti
  * @param regAddr First register regAddr to read from
  * @param length Number of bytes to read
  * @param data Buffer to store read data in
- * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2C_readTimeout)
- * @return I2C_TransferReturn_TypeDef http://downloads.energymicro.com/documentation/doxygen/group__I2C.html
+ * @param timeout Read timeout in milliseconds (0: default timeout, I2C_MASTER_TIMEOUT_MS)
+ * @return Number of bytes read (0 on error)
  */
-int8_t I2C_readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
-	i2c_cmd_handle_t cmd;
-	I2C_SelectRegister(devAddr, regAddr);
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_READ, 1));
-
-	if(length>1)
-	ESP_ERROR_CHECK(i2c_master_read(cmd, data, length-1, I2C_MASTER_ACK));
-
-	ESP_ERROR_CHECK(i2c_master_read_byte(cmd, data+length-1, I2C_MASTER_NACK));
-
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
+int16_t I2C_readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
+	return I2C_read(devAddr, regAddr, length, data, timeout, I2C_retries(devAddr));
+}
 
-	return length;
+/** Read multiple bytes from an 8-bit device register, without retries.
+ * @return Number of bytes read (0 on error)
+ */
+int16_t I2C_readBytesOnce(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
+	return I2C_read(devAddr, regAddr, length, data, timeout, 0);
 }
 
+
 bool I2C_writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data){
 
 	uint8_t data1[] = {(uint8_t)(data>>8), (uint8_t)(data & 0xff)};
-	I2C_writeBytes(devAddr, regAddr, 2, data1);
-	return true;
+	return I2C_writeBytes(devAddr, regAddr, 2, data1);
 }
 
 void I2C_SelectRegister(uint8_t devAddr, uint8_t reg){
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, reg, 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
+	i2c_master_dev_handle_t dev = I2C_device(devAddr);
+	if(dev != NULL){
+		ESP_ERROR_CHECK(i2c_master_transmit(dev, &reg, 1, I2C_MASTER_TIMEOUT_MS));
+	}
 }
 
 /** write a single bit in an 8-bit device register.
@@ -171,7 +407,9 @@ void I2C_SelectRegister(uint8_t devAddr, uint8_t reg){
  */
 bool I2C_writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data) {
     uint8_t b;
-    I2C_readByte(devAddr, regAddr, &b, 0);
+    if (!I2C_readCurrent(devAddr, regAddr, &b)) {
+        return false;
+    }
     b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
     return I2C_writeByte(devAddr, regAddr, b);
 }
@@ -193,7 +431,7 @@ bool I2C_writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t l
     // 10100011 original & ~mask
     // 10101011 masked | value
     uint8_t b = 0;
-    if (I2C_readByte(devAddr, regAddr, &b, 0) != 0) {
+    if (I2C_readCurrent(devAddr, regAddr, &b)) {
         uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
         data <<= (bitStart - length + 1); // shift data into correct position
         data &= mask; // zero all non-important bits in data
@@ -212,18 +450,7 @@ bool I2C_writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t l
  * @return Status of operation (true = success)
  */
 bool I2C_writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, regAddr, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, data, 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
-
-	return true;
+	return I2C_writeBytes(devAddr, regAddr, 1, &data);
 }
 
 /** Write single byte to an 8-bit device register.
@@ -234,18 +461,33 @@ bool I2C_writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
  * @return Status of operation (true = success)
  */
 bool I2C_writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data){
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, regAddr, 1));
-	ESP_ERROR_CHECK(i2c_master_write(cmd, data, length-1, 0));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, data[length-1], 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS);
-	i2c_cmd_link_delete(cmd);
-	return true;
+	uint8_t buffer[I2C_MAX_WRITE + 1];
+	i2c_master_dev_handle_t dev = I2C_device(devAddr);
+	if((dev == NULL) || (length > I2C_MAX_WRITE)){
+		return false;
+	}
+	/* Register address and data are sent in the same write */
+	buffer[0] = regAddr;
+	memcpy(&buffer[1], data, length);
+	esp_err_t rc;
+	uint8_t retries = I2C_retries(devAddr);
+	do{
+		rc = i2c_master_transmit(dev, buffer, length + 1, I2C_MASTER_TIMEOUT_MS);
+	} while((rc != ESP_OK) && (retries-- > 0));
+	ESP_ERROR_CHECK(rc);
+	/* Write-through: single registers are cached, blocks (that could be FIFO or memory 
+	 * ports instead of consecutive registers) are invalidated */
+	i2c_device_t *shadow = I2C_shadow(devAddr);
+	if(shadow != NULL){
+		if((rc == ESP_OK) && (length == 1)){
+			I2C_shadowStore(shadow, regAddr, data[0]);
+		} else {
+			for(uint16_t reg = regAddr; (reg < regAddr + length) && (reg < I2C_REG_QTY); reg++){
+				shadow->shadow_valid[reg / 32] &= ~(1UL << (reg % 32));
+			}
+		}
+	}
+	return rc == ESP_OK;
 }
 
 
@@ -259,9 +501,168 @@ bool I2C_writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *d
  */
 int8_t I2C_readWord(uint8_t devAddr, uint8_t regAddr, uint16_t *data, uint16_t timeout){
 	uint8_t msb[2] = {0,0};
-	I2C_readBytes(devAddr, regAddr, 2, msb, 0);
+	int8_t count = I2C_readBytes(devAddr, regAddr, 2, msb, timeout);
 	*data = (int16_t)((msb[0] << 8) | msb[1]);
-	return 0;
+	return count;
+}
+
+uint8_t I2C_scan(uint8_t *found, uint8_t max){
+	uint8_t count = 0;
+	i2c_device_t *dev;
+	if(i2c_bus == NULL){
+		return 0;
+	}
+	for(uint8_t addr = I2C_SCAN_FIRST_ADDR; addr <= I2C_SCAN_LAST_ADDR; addr++){
+		if(i2c_master_probe(i2c_bus, addr, I2C_SCAN_TIMEOUT_MS) != ESP_OK){
+			continue;
+		}
+		if((found != NULL) && (count < max)){
+			found[count] = addr;
+		}
+		count++;
+		dev = I2C_deviceEntry(addr);
+		if(dev != NULL){
+			dev->present = true;
+		}
+	}
+	return count;
+}
+
+bool I2C_setDeviceSpeed(uint8_t devAddr, uint32_t maxClockHz, uint8_t retries){
+	i2c_device_t *dev = I2C_deviceEntry(devAddr);
+	if(dev == NULL){
+		return false;
+	}
+	taskENTER_CRITICAL(&i2c_table_lock);
+	dev->max_clock = maxClockHz;
+	dev->retries = retries;
+	dev->present = true;
+	taskEXIT_CRITICAL(&i2c_table_lock);
+	return true;
+}
+
+uint32_t I2C_negotiateSpeed(void){
+	uint32_t clock = I2C_MCU_MAX_FREQ_HZ;
+	taskENTER_CRITICAL(&i2c_table_lock);
+	for(uint8_t i = 0; i < i2c_device_count; i++){
+		if(i2c_devices[i].present && (i2c_devices[i].max_clock < clock)){
+			clock = i2c_devices[i].max_clock;
+		}
+	}
+	taskEXIT_CRITICAL(&i2c_table_lock);
+	if(clock != i2c_clock){
+		/* The SCL frequency is fixed when a handle is added: handles are added again lazily */
+		I2C_detachAll();
+		i2c_clock = clock;
+	}
+	return i2c_clock;
+}
+
+uint32_t I2C_getClock(void){
+	return i2c_clock;
+}
+
+bool I2C_shadowEnable(uint8_t devAddr){
+	uint8_t idx;
+	if(I2C_device(devAddr) == NULL){
+		return false;
+	}
+	idx = I2C_deviceIndex(devAddr);
+	xSemaphoreTake(i2c_handle_mutex, portMAX_DELAY);
+	if(i2c_devices[idx].shadow == NULL){
+		memset(i2c_devices[idx].shadow_valid, 0, sizeof(i2c_devices[idx].shadow_valid));
+		i2c_devices[idx].shadow = malloc(I2C_REG_QTY);
+	}
+	xSemaphoreGive(i2c_handle_mutex);
+	return i2c_devices[idx].shadow != NULL;
+}
+
+void I2C_shadowInvalidate(uint8_t devAddr, uint8_t regAddr){
+	i2c_device_t *dev = I2C_shadow(devAddr);
+	if(dev != NULL){
+		dev->shadow_valid[regAddr / 32] &= ~(1UL << (regAddr % 32));
+	}
+}
+
+void I2C_shadowInvalidateAll(uint8_t devAddr){
+	i2c_device_t *dev = I2C_shadow(devAddr);
+	if(dev != NULL){
+		memset(dev->shadow_valid, 0, sizeof(dev->shadow_valid));
+	}
+}
+
+bool I2C_shadowRefresh(uint8_t devAddr, uint8_t regAddr, uint8_t length){
+	uint8_t data[I2C_SHADOW_CHUNK];
+	uint16_t reg = regAddr;
+	/* Registers past the last address can't be cached */
+	uint16_t end = (regAddr + length < I2C_REG_QTY) ? (regAddr + length) : I2C_REG_QTY;
+	uint8_t chunk;
+	i2c_device_t *dev = I2C_shadow(devAddr);
+	if((dev == NULL) || (length == 0)){
+		return false;
+	}
+	while(reg < end){
+		chunk = (end - reg < I2C_SHADOW_CHUNK) ? (end - reg) : I2C_SHADOW_CHUNK;
+		if(I2C_readBytes(devAddr, reg, chunk, data, 0) != (int16_t)chunk){
+			return false;
+		}
+		for(uint8_t i = 0; i < chunk; i++){
+			I2C_shadowStore(dev, reg + i, data[i]);
+		}
+		reg += chunk;
+	}
+	return true;
+}
+
+bool I2C_queueInit(uint8_t queue_size, uint8_t priority){
+	if(i2c_queue != NULL){
+		return true;
+	}
+	i2c_queue = xQueueCreate(queue_size, sizeof(i2c_transaction_t *));
+	if(i2c_queue == NULL){
+		return false;
+	}
+	if(xTaskCreate(I2C_queueTask, "i2c_queue_task", I2C_QUEUE_TASK_STACK, NULL, priority, NULL) != pdPASS){
+		/* No owner task: drop the queue so a later call can retry */
+		vQueueDelete(i2c_queue);
+		i2c_queue = NULL;
+		return false;
+	}
+	return true;
+}
+
+bool I2C_queueSubmit(i2c_transaction_t *transaction, uint32_t timeout_ms){
+	if(i2c_queue == NULL){
+		return false;
+	}
+	transaction->done = false;
+	transaction->ok = false;
+	transaction->submit_time = esp_timer_get_time();
+	/* The device is added to the bus now, so the owner task doesn't have to */
+	if(I2C_device(transaction->devAddr) == NULL){
+		return false;
+	}
+	return xQueueSend(i2c_queue, &transaction, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+bool I2C_getStats(uint8_t devAddr, i2c_dev_stats_t *stats){
+	uint8_t idx = I2C_deviceIndex(devAddr);
+	if(idx == I2C_MAX_DEVICES){
+		return false;
+	}
+	taskENTER_CRITICAL(&i2c_table_lock);
+	*stats = i2c_devices[idx].stats;
+	taskEXIT_CRITICAL(&i2c_table_lock);
+	return true;
+}
+
+void I2C_resetStats(uint8_t devAddr){
+	uint8_t idx = I2C_deviceIndex(devAddr);
+	if(idx < I2C_MAX_DEVICES){
+		taskENTER_CRITICAL(&i2c_table_lock);
+		memset(&i2c_devices[idx].stats, 0, sizeof(i2c_dev_stats_t));
+		taskEXIT_CRITICAL(&i2c_table_lock);
+	}
 }
 
 /*==================[end of file]============================================*/
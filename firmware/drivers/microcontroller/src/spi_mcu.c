@@ -14,6 +14,9 @@
 #include <stdint.h>
 #include <string.h>
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_attr.h"
 #include "gpio_mcu.h"
 /*==================[macros and definitions]=================================*/
 #define PIN_NUM_MISO	GPIO_22	/*!<  */
@@ -22,6 +25,9 @@
 #define PIN_NUM_CS1		GPIO_19	/*!<  */
 #define PIN_NUM_CS2		GPIO_18	/*!<  */
 #define PIN_NUM_CS3		GPIO_9	/*!<  */
+#define SPI_DEV_QTY		3		/*!< Number of devices that can be connected to the bus */
+#define SPI_BOUNCE_SIZE	4092	/*!< Size of each DMA bounce buffer used to send data DMA can't reach */
+#define SPI_FALLBACK_SIZE	256		/*!< Static bounce buffer used when the DMA heap can't hold the bounce buffers */
 /*==================[internal data declaration]==============================*/
 spi_device_handle_t spi_1, spi_2, spi_3;
 const spi_bus_config_t bus_cfg = {
@@ -30,7 +36,7 @@ const spi_bus_config_t bus_cfg = {
     .sclk_io_num = PIN_NUM_CLK,
     .quadwp_io_num = -1,
     .quadhd_io_num = -1,
-    .max_transfer_sz = 4092
+    .max_transfer_sz = SPI_MAX_CHUNK_SIZE
 };
 transfer_mode_t transfer_mode_1, transfer_mode_2, transfer_mode_3;
 void (*spi_1_isr_p)(void*);	/*!<  */
@@ -39,25 +45,297 @@ void (*spi_3_isr_p)(void*);	/*!<  */
 void *spi_1_user_data;	    /*!<  */
 void *spi_2_user_data;	    /*!<  */
 void *spi_3_user_data;	    /*!<  */
+
+/**
+ * @brief Pre-allocated transaction used by the queued (asynchronous) and burst API
+ */
+typedef struct {
+	spi_transaction_t t;			/*!< IDF transaction (must be the first member) */
+	spi_dev_t device;				/*!< Device the transaction belongs to */
+	void (*func_p)(void*);			/*!< Callback called (from ISR) when the transaction ends */
+	void *param_p;					/*!< Callback parameter */
+	bool call_pre;					/*!< Call the device pre-transaction callback before the transaction */
+	void *pre_param_p;				/*!< Parameter for the device pre-transaction callback */
+} spi_queued_trans_t;
+
+/**
+ * @brief Transaction pool of a device. Transactions are used in order, as a circular buffer,
+ * because the SPI driver returns results in the same order they were queued.
+ */
+typedef struct {
+	spi_queued_trans_t trans[SPI_QUEUE_SIZE];	/*!< Transactions */
+	uint8_t head;								/*!< Next transaction to be queued */
+	uint8_t pending;							/*!< Transactions queued whose result was not retrieved */
+} spi_pool_t;
+
+static spi_pool_t spi_pool[SPI_DEV_QTY];		/*!< One transaction pool for each device */
+static bool spi_registered[SPI_DEV_QTY];		/*!< Devices already added to the bus */
+static void (*spi_pre_isr_p[SPI_DEV_QTY])(void*);	/*!< Pre-transaction callback of each device */
+static spi_queued_trans_t spi_burst_trans[SPI_DEV_QTY];	/*!< Transaction used in burst mode */
+static uint8_t *spi_bounce[2];					/*!< DMA bounce buffers (allocated on first use) */
+static DMA_ATTR uint8_t spi_fallback[SPI_FALLBACK_SIZE];	/*!< Bounce buffer when spi_bounce can't be allocated */
+static uint8_t spi_burst_count[SPI_DEV_QTY];	/*!< Nesting level of SpiBurstBegin() */
 /*==================[internal functions declaration]=========================*/
+static void IRAM_ATTR spi_pre_isr(spi_transaction_t *t){
+	spi_queued_trans_t *qt = t->user;
+	if((qt != NULL) && qt->call_pre && (spi_pre_isr_p[qt->device] != NULL)){
+		spi_pre_isr_p[qt->device](qt->pre_param_p);
+	}
+}
 static void IRAM_ATTR spi_1_isr(spi_transaction_t *t){
-	spi_1_isr_p(spi_1_user_data);
+	spi_queued_trans_t *qt = t->user;
+	if(qt != NULL){
+		if(qt->func_p != NULL){
+			qt->func_p(qt->param_p);
+		}
+	} else if(transfer_mode_1 == SPI_INTERRUPT){
+		spi_1_isr_p(spi_1_user_data);
+	}
 }
 static void IRAM_ATTR spi_2_isr(spi_transaction_t *t){
-	spi_2_isr_p(spi_2_user_data);
+	spi_queued_trans_t *qt = t->user;
+	if(qt != NULL){
+		if(qt->func_p != NULL){
+			qt->func_p(qt->param_p);
+		}
+	} else if(transfer_mode_2 == SPI_INTERRUPT){
+		spi_2_isr_p(spi_2_user_data);
+	}
 }
 static void IRAM_ATTR spi_3_isr(spi_transaction_t *t){
-	spi_3_isr_p(spi_3_user_data);
+	spi_queued_trans_t *qt = t->user;
+	if(qt != NULL){
+		if(qt->func_p != NULL){
+			qt->func_p(qt->param_p);
+		}
+	} else if(transfer_mode_3 == SPI_INTERRUPT){
+		spi_3_isr_p(spi_3_user_data);
+	}
 }
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/**
+ * @brief Get the IDF handle of a device
+ */
+static spi_device_handle_t SpiHandle(spi_dev_t device){
+	switch(device){
+		case SPI_1:
+			return spi_1;
+		case SPI_2:
+			return spi_2;
+		case SPI_3:
+			return spi_3;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Get the transfer mode of a device
+ */
+static transfer_mode_t SpiTransferMode(spi_dev_t device){
+	switch(device){
+		case SPI_1:
+			return transfer_mode_1;
+		case SPI_2:
+			return transfer_mode_2;
+		case SPI_3:
+			return transfer_mode_3;
+	}
+	return SPI_POLLING;
+}
+
+/**
+ * @brief Retrieve the result of the oldest queued transaction and release it
+ * 
+ * @return true if a transaction was released
+ */
+static bool SpiReleaseOldest(spi_dev_t device, TickType_t ticks_to_wait, uint8_t **buffer){
+	spi_pool_t *pool = &spi_pool[device];
+	spi_transaction_t *t;
+	if(pool->pending == 0){
+		return false;
+	}
+	if(spi_device_get_trans_result(SpiHandle(device), &t, ticks_to_wait) != ESP_OK){
+		return false;
+	}
+	pool->pending--;
+	if(buffer != NULL){
+		*buffer = (t->rx_buffer != NULL) ? t->rx_buffer : (uint8_t *)t->tx_buffer;
+	}
+	return true;
+}
+
+/**
+ * @brief Polling and queued transactions can't be mixed on the same device, so every
+ * queued transaction has to be finished before starting a blocking one.
+ */
+static void SpiWaitQueued(spi_dev_t device){
+	while(SpiReleaseOldest(device, portMAX_DELAY, NULL));
+}
+
+/**
+ * @brief Take a transaction from the pool and queue it
+ */
+static uint8_t SpiQueue(spi_dev_t device, const uint8_t *tx_buffer, uint8_t *rx_buffer, uint32_t size, void *func_p, void *param_p, bool call_pre, void *pre_param_p){
+	spi_pool_t *pool = &spi_pool[device];
+	spi_queued_trans_t *qt;
+	/* If the pool is full the oldest transaction is released (waiting for it if necessary) */
+	if(pool->pending == SPI_QUEUE_SIZE){
+		SpiReleaseOldest(device, portMAX_DELAY, NULL);
+	}
+	qt = &pool->trans[pool->head];
+	memset(&qt->t, 0, sizeof(qt->t));
+	qt->t.length = size * 8;
+	qt->t.tx_buffer = tx_buffer;
+	if(rx_buffer != NULL){
+		qt->t.rxlength = size * 8;
+		qt->t.rx_buffer = rx_buffer;
+	}
+	qt->t.user = qt;
+	qt->device = device;
+	qt->func_p = func_p;
+	qt->param_p = param_p;
+	qt->call_pre = call_pre;
+	qt->pre_param_p = pre_param_p;
+	if(spi_device_queue_trans(SpiHandle(device), &qt->t, portMAX_DELAY) != ESP_OK){
+		return false;
+	}
+	pool->head = (pool->head + 1) % SPI_QUEUE_SIZE;
+	pool->pending++;
+	return true;
+}
+
+/**
+ * @brief Callback configured in SpiInit for SPI_INTERRUPT transfer mode (NULL in SPI_POLLING mode)
+ */
+static void SpiEndCallback(spi_dev_t device, void **func_p, void **param_p){
+	*func_p = NULL;
+	*param_p = NULL;
+	switch(device){
+		case SPI_1:
+			if(transfer_mode_1 == SPI_INTERRUPT){
+				*func_p = spi_1_isr_p;
+				*param_p = spi_1_user_data;
+			}
+			break;
+		case SPI_2:
+			if(transfer_mode_2 == SPI_INTERRUPT){
+				*func_p = spi_2_isr_p;
+				*param_p = spi_2_user_data;
+			}
+			break;
+		case SPI_3:
+			if(transfer_mode_3 == SPI_INTERRUPT){
+				*func_p = spi_3_isr_p;
+				*param_p = spi_3_user_data;
+			}
+			break;
+	}
+}
+
+/**
+ * @brief Blocking transfer of any size.
+ * 
+ * Transfers that fit in one DMA transaction are sent as a single polling (or interrupt) 
+ * transaction. Bigger ones are split in SPI_MAX_CHUNK_SIZE chunks that are queued back-to-back, 
+ * and tx data that DMA can't reach (e.g. constants in flash) is copied to two bounce buffers 
+ * alternately, so the next chunk is prepared while the previous one is being sent.
+ * If the bounce buffers can't be allocated the data is sent through a small static buffer,
+ * one chunk at a time.
+ */
+static void SpiTransfer(spi_dev_t device, const uint8_t *tx_buffer, uint8_t *rx_buffer, uint32_t size, bool call_pre, void *pre_param_p){
+	spi_queued_trans_t *qt = &spi_burst_trans[device];
+	bool bounce = (tx_buffer != NULL) && !esp_ptr_dma_capable(tx_buffer);
+	uint32_t chunk_max = bounce ? SPI_BOUNCE_SIZE : SPI_MAX_CHUNK_SIZE;
+	uint32_t chunk, offset = 0;
+	uint8_t bounce_idx = 0;
+	uint8_t *bounce_buf[2] = {spi_bounce[0], spi_bounce[1]};
+	uint8_t in_flight = 2;
+	void *func_p, *param_p;
+
+	SpiWaitQueued(device);
+	if(size <= chunk_max && !bounce){
+		memset(&qt->t, 0, sizeof(qt->t));
+		qt->t.length = size * 8;
+		qt->t.tx_buffer = tx_buffer;
+		if(rx_buffer != NULL){
+			qt->t.rxlength = size * 8;
+			qt->t.rx_buffer = rx_buffer;
+		}
+		qt->device = device;
+		qt->func_p = NULL;
+		qt->param_p = NULL;
+		qt->call_pre = call_pre;
+		qt->pre_param_p = pre_param_p;
+		SpiEndCallback(device, (void**)&qt->func_p, &qt->param_p);
+		qt->t.user = qt;
+		if(SpiTransferMode(device) == SPI_INTERRUPT){
+			spi_device_transmit(SpiHandle(device), &qt->t);
+		} else {
+			spi_device_polling_transmit(SpiHandle(device), &qt->t);
+		}
+		return;
+	}
+	if(bounce && (spi_bounce[0] == NULL)){
+		spi_bounce[0] = SpiDmaMalloc(SPI_BOUNCE_SIZE);
+		spi_bounce[1] = SpiDmaMalloc(SPI_BOUNCE_SIZE);
+		if((spi_bounce[0] == NULL) || (spi_bounce[1] == NULL)){
+			/* Fragmented DMA heap: keep nothing, the allocation is tried again on the next transfer */
+			SpiDmaFree(spi_bounce[0]);
+			SpiDmaFree(spi_bounce[1]);
+			spi_bounce[0] = NULL;
+			spi_bounce[1] = NULL;
+		}
+		bounce_buf[0] = spi_bounce[0];
+		bounce_buf[1] = spi_bounce[1];
+	}
+	if(bounce && (bounce_buf[0] == NULL)){
+		bounce_buf[0] = spi_fallback;
+		bounce_buf[1] = spi_fallback;
+		chunk_max = SPI_FALLBACK_SIZE;
+		in_flight = 1;
+	}
+	/* The bus is kept while the chunks are queued (bounce buffers are shared by all devices) */
+	SpiBurstBegin(device);
+	while(offset < size){
+		chunk = size - offset;
+		if(chunk > chunk_max){
+			chunk = chunk_max;
+		}
+		/* Transfer end callback is only called after the last chunk */
+		func_p = NULL;
+		param_p = NULL;
+		if(offset + chunk == size){
+			SpiEndCallback(device, &func_p, &param_p);
+		}
+		if(bounce){
+			/* Wait for the chunk that used this bounce buffer (two transactions ago, or the last one with the fallback buffer) */
+			if(SpiQueuePending(device) == in_flight){
+				SpiReleaseOldest(device, portMAX_DELAY, NULL);
+			}
+			memcpy(bounce_buf[bounce_idx], &tx_buffer[offset], chunk);
+			SpiQueue(device, bounce_buf[bounce_idx], (rx_buffer != NULL) ? &rx_buffer[offset] : NULL, chunk, func_p, param_p, call_pre, pre_param_p);
+			bounce_idx ^= 1;
+		} else {
+			SpiQueue(device, (tx_buffer != NULL) ? &tx_buffer[offset] : NULL, (rx_buffer != NULL) ? &rx_buffer[offset] : NULL, chunk, func_p, param_p, call_pre, pre_param_p);
+		}
+		offset += chunk;
+	}
+	SpiWaitQueued(device);
+	SpiBurstEnd(device);
+}
 
 /*==================[external functions definition]==========================*/
 uint8_t SpiInit(spi_mcu_config_t* spi){
     static bool spi_initialized = false;
+    spi_device_handle_t *handle = NULL;
+    /* A device is added to the bus only once, it keeps its handle until SpiDeInit() */
+    if(spi_registered[spi->device]){
+        return false;
+    }
     if(!spi_initialized){
 	    spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO);
         spi_initialized = true;
@@ -65,165 +343,144 @@ uint8_t SpiInit(spi_mcu_config_t* spi){
 	spi_device_interface_config_t dev_cfg = {
         .clock_speed_hz = spi->bitrate,     	
         .mode = spi->clk_mode,                  
-        .queue_size = 8,                        
+        .queue_size = SPI_QUEUE_SIZE,
+        .pre_cb = spi_pre_isr,
     };
     switch(spi->device){
         case SPI_1:
             dev_cfg.spics_io_num = PIN_NUM_CS1;
             transfer_mode_1 = spi->transfer_mode;
-            if(transfer_mode_1 == SPI_INTERRUPT){
-                dev_cfg.post_cb = spi_1_isr;
-            } 
-            spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_1);
+            dev_cfg.post_cb = spi_1_isr;
             spi_1_isr_p = spi->func_p;
             spi_1_user_data = spi->param_p;
+            handle = &spi_1;
             break;
         case SPI_2:
             dev_cfg.spics_io_num = PIN_NUM_CS2;
-            if(transfer_mode_2 == SPI_INTERRUPT){
-                dev_cfg.post_cb = spi_2_isr;
-            } 
-            transfer_mode_1 = spi->transfer_mode;
-            spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_2);
+            transfer_mode_2 = spi->transfer_mode;
+            dev_cfg.post_cb = spi_2_isr;
             spi_2_isr_p = spi->func_p;
             spi_2_user_data = spi->param_p;
+            handle = &spi_2;
             break;
         case SPI_3:
             dev_cfg.spics_io_num = PIN_NUM_CS3;
-            if(transfer_mode_3 == SPI_INTERRUPT){
-                dev_cfg.post_cb = spi_3_isr;
-            } 
-            transfer_mode_1 = spi->transfer_mode;
-            spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_3);
+            transfer_mode_3 = spi->transfer_mode;
+            dev_cfg.post_cb = spi_3_isr;
             spi_3_isr_p = spi->func_p;
             spi_3_user_data = spi->param_p;
+            handle = &spi_3;
             break;
     }
-    return 0;
+    if(spi_bus_add_device(SPI2_HOST, &dev_cfg, handle) != ESP_OK){
+        return false;
+    }
+    spi_pre_isr_p[spi->device] = spi->pre_func_p;
+    spi_pool[spi->device].head = 0;
+    spi_pool[spi->device].pending = 0;
+    spi_burst_count[spi->device] = 0;
+    spi_registered[spi->device] = true;
+    return true;
+}
+
+bool SpiIsInitialized(spi_dev_t device){
+    return spi_registered[device];
 }
 
 void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size){
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));       // Zero out the transaction
-    t.length = rx_buffer_size * 8;  // tx_buffer_size is in bytes, transaction length is in bits.
-    t.rxlength = rx_buffer_size * 8;
-    t.rx_buffer = rx_buffer;        // Data
-    switch(device){
-        case SPI_1:
-            switch(transfer_mode_1){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_1, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_1, &t); 
-                    break;
-            }
-            break;
-        case SPI_2:
-            switch(transfer_mode_2){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_2, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_2, &t); 
-                    break;
-            }
-            break;
-        case SPI_3:
-            switch(transfer_mode_3){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_3, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_3, &t); 
-                    break;
-            }
-            break;
-    }
+    SpiTransfer(device, NULL, rx_buffer, rx_buffer_size, false, NULL);
 }
 
 void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size){
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));       // Zero out the transaction
-    t.length = tx_buffer_size * 8;  // tx_buffer_size is in bytes, transaction length is in bits.
-    t.tx_buffer = tx_buffer;        // Data
-    switch(device){
-        case SPI_1:
-            switch(transfer_mode_1){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_1, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_1, &t); 
-                    break;
-            }
-            break;
-        case SPI_2:
-            switch(transfer_mode_2){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_2, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_2, &t); 
-                    break;
-            }
-            break;
-        case SPI_3:
-            switch(transfer_mode_3){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_3, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_3, &t); 
-                    break;
-            }
-            break;
-    }
+    SpiTransfer(device, tx_buffer, NULL, tx_buffer_size, false, NULL);
 }
 
 void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size){
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));       // Zero out the transaction
-    t.length = buffer_size * 8;     // tx_buffer_size is in bytes, transaction length is in bits.
-    t.rxlength = buffer_size * 8;
-    t.tx_buffer = tx_buffer;        // Data
-    t.rx_buffer = rx_buffer;        
-    switch(device){
-        case SPI_1:
-            switch(transfer_mode_1){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_1, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_1, &t); 
-                    break;
-            }
-            break;
-        case SPI_2:
-            switch(transfer_mode_2){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_2, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_2, &t); 
-                    break;
-            }
-            break;
-        case SPI_3:
-            switch(transfer_mode_3){
-                case SPI_POLLING:
-                    spi_device_polling_transmit(spi_3, &t); 
-                    break;
-                case SPI_INTERRUPT:
-                    spi_device_transmit(spi_3, &t); 
-                    break;
-            }
-            break;
+    SpiTransfer(device, tx_buffer, rx_buffer, buffer_size, false, NULL);
+}
+
+uint8_t SpiQueueWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size, void *func_p, void *param_p){
+    return SpiQueue(device, tx_buffer, NULL, tx_buffer_size, func_p, param_p, false, NULL);
+}
+
+uint8_t SpiQueueRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size, void *func_p, void *param_p){
+    return SpiQueue(device, NULL, rx_buffer, rx_buffer_size, func_p, param_p, false, NULL);
+}
+
+uint8_t SpiQueueReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size, void *func_p, void *param_p){
+    return SpiQueue(device, tx_buffer, rx_buffer, buffer_size, func_p, param_p, false, NULL);
+}
+
+uint8_t SpiGetResult(spi_dev_t device, uint8_t ** buffer, uint32_t timeout_ms){
+    TickType_t ticks = (timeout_ms == SPI_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return SpiReleaseOldest(device, ticks, buffer);
+}
+
+uint8_t SpiQueuePending(spi_dev_t device){
+    return spi_pool[device].pending;
+}
+
+uint8_t SpiBurstBegin(spi_dev_t device){
+    if(spi_burst_count[device] == 0){
+        SpiWaitQueued(device);
+        if(spi_device_acquire_bus(SpiHandle(device), portMAX_DELAY) != ESP_OK){
+            return false;
+        }
+    }
+    spi_burst_count[device]++;
+    return true;
+}
+
+uint8_t SpiBurstWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size, void *pre_param_p){
+    spi_queued_trans_t *qt = &spi_burst_trans[device];
+    if(tx_buffer_size > sizeof(qt->t.tx_data)){
+        SpiTransfer(device, tx_buffer, NULL, tx_buffer_size, true, pre_param_p);
+        return true;
+    }
+    /* Transfers queued outside the burst (e.g. by a callback) must end before polling */
+    SpiWaitQueued(device);
+    /* Short transfers (commands, parameters) are sent from the transaction itself, without DMA */
+    memset(&qt->t, 0, sizeof(qt->t));
+    qt->t.length = tx_buffer_size * 8;
+    qt->t.flags = SPI_TRANS_USE_TXDATA;
+    memcpy(qt->t.tx_data, tx_buffer, tx_buffer_size);
+    qt->t.user = qt;
+    qt->device = device;
+    qt->func_p = NULL;
+    qt->param_p = NULL;
+    qt->call_pre = true;
+    qt->pre_param_p = pre_param_p;
+    return spi_device_polling_transmit(SpiHandle(device), &qt->t) == ESP_OK;
+}
+
+void SpiBurstEnd(spi_dev_t device){
+    if(spi_burst_count[device] == 0){
+        return;
+    }
+    spi_burst_count[device]--;
+    if(spi_burst_count[device] == 0){
+        spi_device_release_bus(SpiHandle(device));
     }
 }
 
+uint8_t * SpiDmaMalloc(uint32_t size){
+    return heap_caps_malloc(size, MALLOC_CAP_DMA);
+}
+
+void SpiDmaFree(uint8_t * buffer){
+    heap_caps_free(buffer);
+}
+
 uint8_t SpiDeInit(spi_dev_t device){
-    return 0;
+    if(!spi_registered[device]){
+        return false;
+    }
+    SpiWaitQueued(device);
+    if(spi_bus_remove_device(SpiHandle(device)) != ESP_OK){
+        return false;
+    }
+    spi_registered[device] = false;
+    return true;
 }
 
 /** @} doxygen end group definition */
@@ -13,16 +13,24 @@
 #include "uart_mcu.h"
 #include "gpio_mcu.h"
 #include "driver/uart.h"
+#include "soc/soc_caps.h"
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "esp_log.h"
 /*==================[macros and definitions]=================================*/
 #define UART_CONN_TX        GPIO_18         /*!<  */
 #define UART_CONN_RX        GPIO_19         /*!<  */
-#define TX_BUFFER_SIZE      256             /*!<  */
-#define RX_BUFFER_SIZE      256             /*!<  */
-#define EVENT_QUEUE_SIZE    16              /*!<  */
+#define TX_BUFFER_SIZE      256             /*!< Default TX ring buffer size */
+#define RX_BUFFER_SIZE      256             /*!< Default RX ring buffer size */
+#define EVENT_QUEUE_SIZE    16              /*!< Default event queue length */
+#define EVENT_TASK_PRIORITY 12              /*!< Default event task priority */
+#define EVENT_TASK_STACK    2048            /*!< Default event task stack size */
 #define READ_TIMEOUT        100             /*!<  */
+#define BAUD_TOLERANCE      50              /*!< Maximum baud rate error (1/BAUD_TOLERANCE = 2%) */
+#define HIGH_BAUD_RATE      1000000         /*!< From this baud rate on the RX FIFO threshold is raised */
+#define RX_FULL_THRESH      100             /*!< RX FIFO full threshold used for high baud rates */
+#define RX_TOUT_THRESH      2               /*!< RX timeout (in symbols) used for high baud rates */
 /*==================[internal data declaration]==============================*/
 void (*uart_pc_isr_p)(void*);	            /*!<  */
 void (*uart_conn_isr_p)(void*);	            /*!<  */
@@ -30,6 +38,10 @@ void *uart_pc_user_data;	                /*!<  */
 void *uart_conn_user_data;	                /*!<  */
 static QueueHandle_t uart_pc_queue;         /*!<  */
 static QueueHandle_t uart_conn_queue;       /*!<  */
+static uint16_t uart_rx_size[2];            /*!< RX buffer size for each port */
+static uint16_t uart_tx_size[2];            /*!< TX buffer size for each port */
+static uint8_t uart_queue_size[2];          /*!< Event queue length for each port */
+static volatile uint32_t uart_ovf_count[2]; /*!< RX overflow counter for each port */
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
@@ -39,7 +51,6 @@ static QueueHandle_t uart_conn_queue;       /*!<  */
 /*==================[internal functions definition]==========================*/
 static void uart_pc_event_task(void *pvParameters){
     uart_event_t event;
-    uart_driver_install(UART_NUM_0, RX_BUFFER_SIZE, TX_BUFFER_SIZE, 16, &uart_pc_queue, 0);
     while(1){
         //Waiting for UART event.
         if (xQueueReceive(uart_pc_queue, (void *)&event, (TickType_t)portMAX_DELAY)){
@@ -50,8 +61,11 @@ static void uart_pc_event_task(void *pvParameters){
                 case UART_BREAK:
                     break;
                 case UART_BUFFER_FULL:
-                    break;
                 case UART_FIFO_OVF:
+                    /* Data can't be trusted anymore: discard it and start again */
+                    uart_ovf_count[UART_PC]++;
+                    uart_flush_input(UART_NUM_0);
+                    xQueueReset(uart_pc_queue);
                     break;
                 case UART_FRAME_ERR:
                     break;
@@ -72,7 +86,6 @@ static void uart_pc_event_task(void *pvParameters){
 
 static void uart_conn_event_task(void *pvParameters){
     uart_event_t event;
-    uart_driver_install(UART_NUM_1, RX_BUFFER_SIZE, TX_BUFFER_SIZE, 16, &uart_conn_queue, 0);
     while(1){
         //Waiting for UART event.
         if(xQueueReceive(uart_conn_queue, (void *)&event, (TickType_t)portMAX_DELAY)){
@@ -83,8 +96,11 @@ static void uart_conn_event_task(void *pvParameters){
                 case UART_BREAK:
                     break;
                 case UART_BUFFER_FULL:
-                    break;
                 case UART_FIFO_OVF:
+                    /* Data can't be trusted anymore: discard it and start again */
+                    uart_ovf_count[UART_CONNECTOR]++;
+                    uart_flush_input(UART_NUM_1);
+                    xQueueReset(uart_conn_queue);
                     break;
                 case UART_FRAME_ERR:
                     break;
@@ -104,7 +120,12 @@ static void uart_conn_event_task(void *pvParameters){
 }
 /*==================[external functions definition]==========================*/
 
-void UartInit(serial_config_t *port_config){
+uint8_t UartInit(serial_config_t *port_config){
+    uart_port_t uart_num = UART_NUM_0;
+    uint32_t baud_rate = 0;
+    uint32_t baud_error = 0;
+    uint8_t task_priority = EVENT_TASK_PRIORITY;
+    uint16_t task_stack = EVENT_TASK_STACK;
     uart_config_t uart_config = {
         .baud_rate = port_config->baud_rate,
         .data_bits = UART_DATA_8_BITS,
@@ -113,30 +134,84 @@ void UartInit(serial_config_t *port_config){
         .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
         .source_clk = UART_SCLK_DEFAULT,
     };
+    int rts_pin = UART_PIN_NO_CHANGE;
+    int cts_pin = UART_PIN_NO_CHANGE;
+
+    if((port_config->baud_rate == 0) || (port_config->baud_rate > UART_MAX_BAUD_RATE)){
+        return false;
+    }
+    if(port_config->hw_flow_ctrl){
+        uart_config.flow_ctrl = UART_HW_FLOWCTRL_CTS_RTS;
+        uart_config.rx_flow_ctrl_thresh = SOC_UART_FIFO_LEN - 16;
+        rts_pin = port_config->rts_pin;
+        cts_pin = port_config->cts_pin;
+    }
+    uart_rx_size[port_config->port] = RX_BUFFER_SIZE;
+    if(port_config->rx_buffer_size > SOC_UART_FIFO_LEN){
+        uart_rx_size[port_config->port] = port_config->rx_buffer_size;
+    }
+    uart_tx_size[port_config->port] = TX_BUFFER_SIZE;
+    if(port_config->tx_buffer_size > SOC_UART_FIFO_LEN){
+        uart_tx_size[port_config->port] = port_config->tx_buffer_size;
+    }
+    uart_queue_size[port_config->port] = EVENT_QUEUE_SIZE;
+    if(port_config->event_queue_size != 0){
+        uart_queue_size[port_config->port] = port_config->event_queue_size;
+    }
+    if(port_config->task_priority != 0){
+        task_priority = port_config->task_priority;
+    }
+    if(port_config->task_stack_size != 0){
+        task_stack = port_config->task_stack_size;
+    }
+    uart_ovf_count[port_config->port] = 0;
+
     switch(port_config->port){
         case UART_PC:
+            uart_num = UART_NUM_0;
             uart_param_config(UART_NUM_0, &uart_config);
-            uart_set_pin(UART_NUM_0, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+            uart_set_pin(UART_NUM_0, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, rts_pin, cts_pin);
             if(port_config->func_p != UART_NO_INT){
                 uart_pc_isr_p = port_config->func_p;
-                uart_pc_queue = port_config->param_p;
-                xTaskCreate(uart_pc_event_task, "uart_pc_event_task", 2048, NULL, 12, 0);
+                uart_pc_user_data = port_config->param_p;
+                /* Driver is installed before creating the task so the queue is ready when it starts */
+                uart_driver_install(UART_NUM_0, uart_rx_size[UART_PC], uart_tx_size[UART_PC], uart_queue_size[UART_PC], &uart_pc_queue, 0);
+                xTaskCreate(uart_pc_event_task, "uart_pc_event_task", task_stack, NULL, task_priority, 0);
             }else{
-                uart_driver_install(UART_NUM_0, RX_BUFFER_SIZE, TX_BUFFER_SIZE, 0, NULL, 0);
+                uart_driver_install(UART_NUM_0, uart_rx_size[UART_PC], uart_tx_size[UART_PC], 0, NULL, 0);
             }
             break;
         case UART_CONNECTOR:
+            uart_num = UART_NUM_1;
             uart_param_config(UART_NUM_1, &uart_config);
-            uart_set_pin(UART_NUM_1, UART_CONN_TX, UART_CONN_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+            uart_set_pin(UART_NUM_1, UART_CONN_TX, UART_CONN_RX, rts_pin, cts_pin);
             if(port_config->func_p != UART_NO_INT){
                 uart_conn_isr_p = port_config->func_p;
-                uart_conn_queue = port_config->param_p;
-                xTaskCreate(uart_conn_event_task, "uart_conn_event_task", 2048, NULL, 12, NULL);
+                uart_conn_user_data = port_config->param_p;
+                uart_driver_install(UART_NUM_1, uart_rx_size[UART_CONNECTOR], uart_tx_size[UART_CONNECTOR], uart_queue_size[UART_CONNECTOR], &uart_conn_queue, 0);
+                xTaskCreate(uart_conn_event_task, "uart_conn_event_task", task_stack, NULL, task_priority, NULL);
             }else{
-                uart_driver_install(UART_NUM_1, RX_BUFFER_SIZE, TX_BUFFER_SIZE, 0, NULL, 0);
+                uart_driver_install(UART_NUM_1, uart_rx_size[UART_CONNECTOR], uart_tx_size[UART_CONNECTOR], 0, NULL, 0);
             }
             break;
     }
+    if(port_config->baud_rate >= HIGH_BAUD_RATE){
+        /* Wake up the driver less often and before the 128 bytes hardware FIFO fills up */
+        uart_set_rx_full_threshold(uart_num, RX_FULL_THRESH);
+        uart_set_rx_timeout(uart_num, RX_TOUT_THRESH);
+    }
+    /* Check the baud rate that the clock divider can really achieve */
+    uart_get_baudrate(uart_num, &baud_rate);
+    if(baud_rate > port_config->baud_rate){
+        baud_error = baud_rate - port_config->baud_rate;
+    }else{
+        baud_error = port_config->baud_rate - baud_rate;
+    }
+    if(baud_error * BAUD_TOLERANCE > port_config->baud_rate){
+        ESP_LOGW("uart", "Baud rate %lu configured as %lu", port_config->baud_rate, baud_rate);
+        return false;
+    }
+    return true;
 }
 
 uint8_t UartReadByte(uart_mcu_port_t port, uint8_t* data){
@@ -200,13 +275,11 @@ void UartSendString(uart_mcu_port_t port, const char *msg){
                 uart_num = UART_NUM_1;
             break;
     }
-	while(*msg != 0){
-        uart_tx_chars(uart_num, msg, 1);
-		msg++;
-	}
+    /* uart_write_bytes() waits for room in the TX ring buffer instead of dropping data */
+    uart_write_bytes(uart_num, msg, strlen(msg));
 }
 
-void UartSendBuffer(uart_mcu_port_t port, const char *data, uint8_t nbytes){
+void UartSendBuffer(uart_mcu_port_t port, const char *data, uint16_t nbytes){
     uart_port_t uart_num = UART_NUM_0;
     switch(port){
         case UART_PC:
@@ -216,7 +289,11 @@ void UartSendBuffer(uart_mcu_port_t port, const char *data, uint8_t nbytes){
                 uart_num = UART_NUM_1;
             break;
     }
-    uart_tx_chars(uart_num, data, nbytes);
+    uart_write_bytes(uart_num, data, nbytes);
+}
+
+uint32_t UartGetOverflowCount(uart_mcu_port_t port){
+    return uart_ovf_count[port];
 }
 
 uint8_t* UartItoa(uint32_t val, uint8_t base){
@@ -0,0 +1,112 @@
+/**
+ * @file dsps_dispatch.h
+ * @brief Runtime selection of the esp-dsp kernel variants
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _dsps_dispatch_H_
+#define _dsps_dispatch_H_
+
+#include "dsp_err.h"
+
+/**
+ * @brief   Runtime selection of the kernel variants
+ *
+ * The dsps_*_platform.h macros select one implementation per function at compile time.
+ * The dispatch table keeps, for each operation and size class, the variant to call
+ * through the _auto functions. Until dsps_dispatch_init() is called the table holds the
+ * compile time selection, so the _auto functions behave like the plain names.
+ *
+ * dsps_dispatch_init() checks every compiled variant (_ansi, _ae32, _aes3, _rv32) against
+ * the ANSI reference and times the valid ones on the running chip: the fastest one of each
+ * size class is selected. For deterministic builds, run it once, print the table with
+ * dsps_dispatch_print() and replay the printed dsps_dispatch_override() calls at boot.
+ *
+ * Size classes: len <= 16, len <= 64, len <= 256 and longer (FFT: N complex points).
+ */
+
+#define DSPS_DISPATCH_SIZES 4   /*!< Number of size classes */
+
+typedef enum dsps_dispatch_op_ {
+    DSPS_DISPATCH_DOTPROD_F32,  /*!< dsps_dotprod_f32 */
+    DSPS_DISPATCH_MUL_F32,      /*!< dsps_mul_f32 */
+    DSPS_DISPATCH_ADD_F32,      /*!< dsps_add_f32 */
+    DSPS_DISPATCH_BIQUAD_F32,   /*!< dsps_biquad_f32 */
+    DSPS_DISPATCH_FFT2R_FC32,   /*!< dsps_fft2r_fc32 */
+    DSPS_DISPATCH_OP_COUNT
+} dsps_dispatch_op_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**@{*/
+/**
+ * @brief   Validate and benchmark the kernel variants
+ *
+ * Size classes fixed with dsps_dispatch_override() are not changed. The FFT is only
+ * benchmarked when the twiddle table is initialized (dsps_fft2r_init_fc32()), and only for
+ * the sizes the table supports; the other size classes keep their selection.
+ * Uses about 32 KB of heap while running.
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_NO_MEM if the test buffers can not be allocated
+ */
+esp_err_t dsps_dispatch_init(void);
+
+/**
+ * @brief   Select a variant
+ *
+ * The variant is validated against the ANSI reference first, and the selected size
+ * classes are excluded from later dsps_dispatch_init() calls.
+ *
+ * @param[in] op: operation
+ * @param[in] len: size class of len, or 0 for all the size classes
+ * @param[in] variant: "ansi", "ae32", "aes3" or "rv32"; NULL restores the compile time
+ *                     selection and unlocks the selected size classes
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if the variant is not compiled for this chip
+ *      - ESP_ERR_DSP_UNINITIALIZED for the FFT if the twiddle table is not initialized
+ *      - ESP_FAIL if the variant results differ from the ANSI reference
+ */
+esp_err_t dsps_dispatch_override(dsps_dispatch_op_t op, int len, const char *variant);
+
+/**
+ * @brief   Selected variant of an operation for a length
+ *
+ * @return variant name ("ansi", "ae32", "aes3" or "rv32")
+ */
+const char *dsps_dispatch_variant(dsps_dispatch_op_t op, int len);
+
+/**
+ * @brief   Print the table as dsps_dispatch_override() calls
+ */
+void dsps_dispatch_print(void);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   Kernels called through the dispatch table
+ *
+ * Same arguments and results as the functions without the extension (_auto).
+ */
+esp_err_t dsps_dotprod_f32_auto(const float *src1, const float *src2, float *dest, int len);
+esp_err_t dsps_mul_f32_auto(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
+esp_err_t dsps_add_f32_auto(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
+esp_err_t dsps_biquad_f32_auto(const float *input, float *output, int len, float *coef, float *w);
+esp_err_t dsps_fft2r_fc32_auto(float *data, int N);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_dispatch_H_
@@ -33,6 +33,7 @@ extern "C"
 #include "dsps_wind.h"
 #include "dsps_conv.h"
 #include "dsps_corr.h"
+#include "dsps_fconv.h"
 
 #include "dsps_d_gen.h"
 #include "dsps_h_gen.h"
@@ -49,6 +50,7 @@ extern "C"
 
 // Support functions
 #include "dsps_view.h"
+#include "dsps_dispatch.h"
 
 // Image processing functions:
 #include "dspi_dotprod.h"
@@ -62,4 +64,9 @@ extern "C"
 #include "mat.h"
 #endif
 
+// Cycle-count profiling wrappers, must be the last include
+#if CONFIG_DSP_PROFILING
+#include "dsp_prof_wrap.h"
+#endif
+
 #endif // _esp_dsp_H_
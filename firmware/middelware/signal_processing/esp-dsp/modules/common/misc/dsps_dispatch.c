@@ -0,0 +1,502 @@
+/**
+ * @file dsps_dispatch.c
+ * @brief Runtime selection of the esp-dsp kernel variants
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <malloc.h>
+#include "dsps_dispatch.h"
+#include "dsp_common.h"
+#include "dsps_dotprod.h"
+#include "dsps_mul.h"
+#include "dsps_add.h"
+#include "dsps_biquad.h"
+#include "dsps_biquad_gen.h"
+#include "dsps_fft2r.h"
+#include "esp_log.h"
+
+static const char *TAG = "dsps_dispatch";
+
+#define DISPATCH_MAX_LEN        1024    // longest benchmarked length
+#define DISPATCH_BUF_LEN        (2 * DISPATCH_MAX_LEN)
+#define DISPATCH_MAX_VARIANTS   4
+#define DISPATCH_BENCH_SAMPLES  2048    // samples processed per timing trial
+#define DISPATCH_BENCH_TRIALS   3
+
+// Expands the first argument before pasting: DISPATCH_XCAT(dsps_fft2r_fc32, _) is the
+// function behind the compile time selection (dsps_fft2r_fc32_rv32_)
+#define DISPATCH_CAT(a, b)      a##b
+#define DISPATCH_XCAT(a, b)     DISPATCH_CAT(a, b)
+
+typedef union {
+    esp_err_t (*dotprod)(const float *src1, const float *src2, float *dest, int len);
+    esp_err_t (*vec)(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
+    esp_err_t (*biquad)(const float *input, float *output, int len, float *coef, float *w);
+    esp_err_t (*fft)(float *data, int N, float *w);
+} dispatch_fn_t;
+
+typedef struct {
+    const char *name;
+    dispatch_fn_t fn;
+} dispatch_variant_t;
+
+typedef struct {
+    const char *op_name;
+    const dispatch_variant_t *variants;
+    int count;
+} dispatch_op_desc_t;
+
+typedef struct {
+    float *x;
+    float *y;
+    float *ref;
+    float *out;
+} dispatch_buf_t;
+
+// Variants compiled for this chip, the ANSI reference first. The _rv32 kernels are
+// portable C and compiled for every target.
+static const dispatch_variant_t dotprod_f32_variants[] = {
+    {"ansi", {.dotprod = dsps_dotprod_f32_ansi}},
+#if (dotprod_f32_ae32_enabled == 1)
+    {"ae32", {.dotprod = dsps_dotprod_f32_ae32}},
+#endif
+#if (dsps_dotprod_f32_aes3_enabled == 1)
+    {"aes3", {.dotprod = dsps_dotprod_f32_aes3}},
+#endif
+    {"rv32", {.dotprod = dsps_dotprod_f32_rv32}},
+};
+
+static const dispatch_variant_t mul_f32_variants[] = {
+    {"ansi", {.vec = dsps_mul_f32_ansi}},
+#if (dsps_mul_f32_ae32_enabled == 1)
+    {"ae32", {.vec = dsps_mul_f32_ae32}},
+#endif
+    {"rv32", {.vec = dsps_mul_f32_rv32}},
+};
+
+static const dispatch_variant_t add_f32_variants[] = {
+    {"ansi", {.vec = dsps_add_f32_ansi}},
+#if (dsps_add_f32_ae32_enabled == 1)
+    {"ae32", {.vec = dsps_add_f32_ae32}},
+#endif
+    {"rv32", {.vec = dsps_add_f32_rv32}},
+};
+
+static const dispatch_variant_t biquad_f32_variants[] = {
+    {"ansi", {.biquad = dsps_biquad_f32_ansi}},
+#if (dsps_biquad_f32_ae32_enabled == 1)
+    {"ae32", {.biquad = dsps_biquad_f32_ae32}},
+#endif
+#if (dsps_biquad_f32_aes3_enabled == 1)
+    {"aes3", {.biquad = dsps_biquad_f32_aes3}},
+#endif
+    {"rv32", {.biquad = dsps_biquad_f32_rv32}},
+};
+
+static const dispatch_variant_t fft2r_fc32_variants[] = {
+    {"ansi", {.fft = dsps_fft2r_fc32_ansi_}},
+#if (dsps_fft2r_fc32_ae32_enabled == 1)
+    {"ae32", {.fft = dsps_fft2r_fc32_ae32_}},
+#endif
+#if (dsps_fft2r_fc32_aes3_enabled == 1)
+    {"aes3", {.fft = dsps_fft2r_fc32_aes3_}},
+#endif
+    {"rv32", {.fft = dsps_fft2r_fc32_rv32_}},
+};
+
+#define DISPATCH_OP(op, variants) [op] = {#op, variants, sizeof(variants) / sizeof(variants[0])}
+
+static const dispatch_op_desc_t dispatch_ops[DSPS_DISPATCH_OP_COUNT] = {
+    DISPATCH_OP(DSPS_DISPATCH_DOTPROD_F32, dotprod_f32_variants),
+    DISPATCH_OP(DSPS_DISPATCH_MUL_F32, mul_f32_variants),
+    DISPATCH_OP(DSPS_DISPATCH_ADD_F32, add_f32_variants),
+    DISPATCH_OP(DSPS_DISPATCH_BIQUAD_F32, biquad_f32_variants),
+    DISPATCH_OP(DSPS_DISPATCH_FFT2R_FC32, fft2r_fc32_variants),
+};
+
+// Compile time selection of the dsps_*_platform.h macros
+static const dispatch_fn_t dispatch_default[DSPS_DISPATCH_OP_COUNT] = {
+    [DSPS_DISPATCH_DOTPROD_F32] = {.dotprod = dsps_dotprod_f32},
+    [DSPS_DISPATCH_MUL_F32] = {.vec = dsps_mul_f32},
+    [DSPS_DISPATCH_ADD_F32] = {.vec = dsps_add_f32},
+    [DSPS_DISPATCH_BIQUAD_F32] = {.biquad = dsps_biquad_f32},
+    [DSPS_DISPATCH_FFT2R_FC32] = {.fft = DISPATCH_XCAT(dsps_fft2r_fc32, _)},
+};
+
+#define DISPATCH_ROW(member, fn) {{.member = fn}, {.member = fn}, {.member = fn}, {.member = fn}}
+
+static dispatch_fn_t dispatch_table[DSPS_DISPATCH_OP_COUNT][DSPS_DISPATCH_SIZES] = {
+    [DSPS_DISPATCH_DOTPROD_F32] = DISPATCH_ROW(dotprod, dsps_dotprod_f32),
+    [DSPS_DISPATCH_MUL_F32] = DISPATCH_ROW(vec, dsps_mul_f32),
+    [DSPS_DISPATCH_ADD_F32] = DISPATCH_ROW(vec, dsps_add_f32),
+    [DSPS_DISPATCH_BIQUAD_F32] = DISPATCH_ROW(biquad, dsps_biquad_f32),
+    [DSPS_DISPATCH_FFT2R_FC32] = DISPATCH_ROW(fft, DISPATCH_XCAT(dsps_fft2r_fc32, _)),
+};
+
+// Size classes fixed with dsps_dispatch_override()
+static bool dispatch_locked[DSPS_DISPATCH_OP_COUNT][DSPS_DISPATCH_SIZES];
+
+// Upper bound of each size class, used as benchmark length
+static const int dispatch_bench_len[DSPS_DISPATCH_SIZES] = {16, 64, 256, DISPATCH_MAX_LEN};
+// Validation lengths: odd ones exercise the unrolled loop tails
+static const int dispatch_check_len[] = {1, 7, 16, 37, 64, 255, DISPATCH_MAX_LEN};
+
+static inline int dispatch_class(int len)
+{
+    return (len <= 16) ? 0 : (len <= 64) ? 1 : (len <= 256) ? 2 : 3;
+}
+
+static bool dispatch_same(dsps_dispatch_op_t op, const dispatch_fn_t *a, const dispatch_fn_t *b)
+{
+    switch (op) {
+    case DSPS_DISPATCH_DOTPROD_F32:
+        return a->dotprod == b->dotprod;
+    case DSPS_DISPATCH_MUL_F32:
+    case DSPS_DISPATCH_ADD_F32:
+        return a->vec == b->vec;
+    case DSPS_DISPATCH_BIQUAD_F32:
+        return a->biquad == b->biquad;
+    default:
+        return a->fft == b->fft;
+    }
+}
+
+// Longest FFT the twiddle table supports (0: not initialized)
+static int dispatch_fft_max_len(void)
+{
+    if (!dsps_fft2r_initialized) {
+        return 0;
+    }
+    return (dsps_fft_w_table_size < DISPATCH_MAX_LEN) ? dsps_fft_w_table_size : DISPATCH_MAX_LEN;
+}
+
+static bool dispatch_alloc(dispatch_buf_t *buf)
+{
+    buf->x = (float *)memalign(16, DISPATCH_BUF_LEN * sizeof(float));
+    buf->y = (float *)memalign(16, DISPATCH_BUF_LEN * sizeof(float));
+    buf->ref = (float *)memalign(16, DISPATCH_BUF_LEN * sizeof(float));
+    buf->out = (float *)memalign(16, DISPATCH_BUF_LEN * sizeof(float));
+    if ((buf->x == NULL) || (buf->y == NULL) || (buf->ref == NULL) || (buf->out == NULL)) {
+        free(buf->x);
+        free(buf->y);
+        free(buf->ref);
+        free(buf->out);
+        return false;
+    }
+    // Deterministic pseudo random data in [-1, 1)
+    uint32_t seed = 12345;
+    for (int i = 0; i < DISPATCH_BUF_LEN; i++) {
+        seed = seed * 1664525 + 1013904223;
+        buf->x[i] = (float)(seed >> 8) / (float)(1 << 23) - 1;
+        seed = seed * 1664525 + 1013904223;
+        buf->y[i] = (float)(seed >> 8) / (float)(1 << 23) - 1;
+    }
+    return true;
+}
+
+static void dispatch_free(dispatch_buf_t *buf)
+{
+    free(buf->x);
+    free(buf->y);
+    free(buf->ref);
+    free(buf->out);
+}
+
+static bool dispatch_compare(const float *ref, const float *out, int len, float tol)
+{
+    for (int i = 0; i < len; i++) {
+        if (!(fabsf(ref[i] - out[i]) <= tol * (1 + fabsf(ref[i])))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool dispatch_check_len_op(dsps_dispatch_op_t op, const dispatch_fn_t *fn, const dispatch_buf_t *buf, int len)
+{
+    const dispatch_fn_t *ref = &dispatch_ops[op].variants[0].fn;
+    esp_err_t ref_ret = ESP_OK;
+    esp_err_t ret = ESP_OK;
+    switch (op) {
+    case DSPS_DISPATCH_DOTPROD_F32: {
+        float ref_dest = 0;
+        float dest = 0;
+        float mag = 0;
+        ref_ret = ref->dotprod(buf->x, buf->y, &ref_dest, len);
+        ret = fn->dotprod(buf->x, buf->y, &dest, len);
+        for (int i = 0; i < len; i++) {
+            mag += fabsf(buf->x[i] * buf->y[i]);
+        }
+        // The summation order differs between variants
+        if (!(fabsf(ref_dest - dest) <= 1e-5f * (1 + mag))) {
+            return false;
+        }
+        break;
+    }
+    case DSPS_DISPATCH_MUL_F32:
+    case DSPS_DISPATCH_ADD_F32: {
+        // Unit steps and, for the short lengths, strided access
+        int step_out = (len < DISPATCH_MAX_LEN) ? 2 : 1;
+        memset(buf->ref, 0, DISPATCH_BUF_LEN * sizeof(float));
+        memset(buf->out, 0, DISPATCH_BUF_LEN * sizeof(float));
+        ref_ret = ref->vec(buf->x, buf->y, buf->ref, len, 1, 1, 1);
+        ret = fn->vec(buf->x, buf->y, buf->out, len, 1, 1, 1);
+        if (!dispatch_compare(buf->ref, buf->out, len, 1e-6f)) {
+            return false;
+        }
+        ref_ret |= ref->vec(buf->x, buf->y, buf->ref, len, 2, 1, step_out);
+        ret |= fn->vec(buf->x, buf->y, buf->out, len, 2, 1, step_out);
+        if (!dispatch_compare(buf->ref, buf->out, len * step_out, 1e-6f)) {
+            return false;
+        }
+        break;
+    }
+    case DSPS_DISPATCH_BIQUAD_F32: {
+        float coef[5];
+        float ref_w[2] = {0, 0};
+        float w[2] = {0, 0};
+        dsps_biquad_gen_lpf_f32(coef, 0.1f, 0.7071f);
+        ref_ret = ref->biquad(buf->x, buf->ref, len, coef, ref_w);
+        ret = fn->biquad(buf->x, buf->out, len, coef, w);
+        if (!dispatch_compare(buf->ref, buf->out, len, 1e-4f) || !dispatch_compare(ref_w, w, 2, 1e-4f)) {
+            return false;
+        }
+        break;
+    }
+    case DSPS_DISPATCH_FFT2R_FC32: {
+        float max = 0;
+        memcpy(buf->ref, buf->x, 2 * len * sizeof(float));
+        memcpy(buf->out, buf->x, 2 * len * sizeof(float));
+        ref_ret = ref->fft(buf->ref, len, dsps_fft_w_table_fc32);
+        ret = fn->fft(buf->out, len, dsps_fft_w_table_fc32);
+        for (int i = 0; i < 2 * len; i++) {
+            max = fmaxf(max, fabsf(buf->ref[i]));
+        }
+        for (int i = 0; i < 2 * len; i++) {
+            if (!(fabsf(buf->ref[i] - buf->out[i]) <= 1e-5f * (1 + max))) {
+                return false;
+            }
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return ret == ref_ret;
+}
+
+// Validate a variant against the ANSI reference
+static bool dispatch_check(dsps_dispatch_op_t op, const dispatch_fn_t *fn, const dispatch_buf_t *buf)
+{
+    if (op == DSPS_DISPATCH_FFT2R_FC32) {
+        for (int len = 16; len <= dispatch_fft_max_len(); len <<= 2) {
+            if (!dispatch_check_len_op(op, fn, buf, len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (size_t i = 0; i < sizeof(dispatch_check_len) / sizeof(dispatch_check_len[0]); i++) {
+        if (!dispatch_check_len_op(op, fn, buf, dispatch_check_len[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Cycles to process DISPATCH_BENCH_SAMPLES samples, best of DISPATCH_BENCH_TRIALS
+static uint32_t dispatch_time(dsps_dispatch_op_t op, const dispatch_fn_t *fn, const dispatch_buf_t *buf, int len)
+{
+    float coef[5];
+    float w[2] = {0, 0};
+    float dest;
+    uint32_t best = UINT32_MAX;
+    int reps = (len < DISPATCH_BENCH_SAMPLES) ? DISPATCH_BENCH_SAMPLES / len : 1;
+    dsps_biquad_gen_lpf_f32(coef, 0.1f, 0.7071f);
+    for (int trial = 0; trial < DISPATCH_BENCH_TRIALS; trial++) {
+        uint32_t total = 0;
+        for (int r = 0; r < reps; r++) {
+            if (op == DSPS_DISPATCH_FFT2R_FC32) {
+                // In place transform: restart from the same data every call
+                memcpy(buf->out, buf->x, 2 * len * sizeof(float));
+            }
+            uint32_t start = dsp_get_cpu_cycle_count();
+            switch (op) {
+            case DSPS_DISPATCH_DOTPROD_F32:
+                fn->dotprod(buf->x, buf->y, &dest, len);
+                break;
+            case DSPS_DISPATCH_MUL_F32:
+            case DSPS_DISPATCH_ADD_F32:
+                fn->vec(buf->x, buf->y, buf->out, len, 1, 1, 1);
+                break;
+            case DSPS_DISPATCH_BIQUAD_F32:
+                fn->biquad(buf->x, buf->out, len, coef, w);
+                break;
+            default:
+                fn->fft(buf->out, len, dsps_fft_w_table_fc32);
+                break;
+            }
+            total += dsp_get_cpu_cycle_count() - start;
+        }
+        if (total < best) {
+            best = total;
+        }
+    }
+    return best;
+}
+
+esp_err_t dsps_dispatch_init(void)
+{
+    dispatch_buf_t buf;
+    if (!dispatch_alloc(&buf)) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int op = 0; op < DSPS_DISPATCH_OP_COUNT; op++) {
+        const dispatch_op_desc_t *desc = &dispatch_ops[op];
+        bool valid[DISPATCH_MAX_VARIANTS];
+        int unlocked = 0;
+        for (int c = 0; c < DSPS_DISPATCH_SIZES; c++) {
+            unlocked += !dispatch_locked[op][c];
+        }
+        if (unlocked == 0) {
+            continue;
+        }
+        if ((op == DSPS_DISPATCH_FFT2R_FC32) && (dispatch_fft_max_len() == 0)) {
+            ESP_LOGW(TAG, "FFT table not initialized, %s keeps the compile time selection", desc->op_name);
+            continue;
+        }
+        for (int v = 0; v < desc->count; v++) {
+            valid[v] = (v == 0) || dispatch_check(op, &desc->variants[v].fn, &buf);
+            if (!valid[v]) {
+                ESP_LOGW(TAG, "%s: %s differs from the ANSI reference, not used", desc->op_name, desc->variants[v].name);
+            }
+        }
+        for (int c = 0; c < DSPS_DISPATCH_SIZES; c++) {
+            int len = dispatch_bench_len[c];
+            int best = 0;
+            uint32_t best_cycles = UINT32_MAX;
+            if (dispatch_locked[op][c]) {
+                continue;
+            }
+            if ((op == DSPS_DISPATCH_FFT2R_FC32) && (len > dispatch_fft_max_len())) {
+                continue;
+            }
+            for (int v = 0; v < desc->count; v++) {
+                if (!valid[v]) {
+                    continue;
+                }
+                uint32_t cycles = dispatch_time(op, &desc->variants[v].fn, &buf, len);
+                ESP_LOGD(TAG, "%s len %i %s: %u cycles", desc->op_name, len, desc->variants[v].name, (unsigned int)cycles);
+                if (cycles < best_cycles) {
+                    best_cycles = cycles;
+                    best = v;
+                }
+            }
+            dispatch_table[op][c] = desc->variants[best].fn;
+        }
+    }
+    dispatch_free(&buf);
+    return ESP_OK;
+}
+
+esp_err_t dsps_dispatch_override(dsps_dispatch_op_t op, int len, const char *variant)
+{
+    if ((op < 0) || (op >= DSPS_DISPATCH_OP_COUNT)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    const dispatch_op_desc_t *desc = &dispatch_ops[op];
+    int first = (len > 0) ? dispatch_class(len) : 0;
+    int last = (len > 0) ? first : DSPS_DISPATCH_SIZES - 1;
+    if (variant == NULL) {
+        for (int c = first; c <= last; c++) {
+            dispatch_table[op][c] = dispatch_default[op];
+            dispatch_locked[op][c] = false;
+        }
+        return ESP_OK;
+    }
+    int v = 0;
+    while ((v < desc->count) && (strcmp(desc->variants[v].name, variant) != 0)) {
+        v++;
+    }
+    if (v == desc->count) {
+        ESP_LOGW(TAG, "%s: variant %s not available", desc->op_name, variant);
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((op == DSPS_DISPATCH_FFT2R_FC32) && (dispatch_fft_max_len() == 0)) {
+        return ESP_ERR_DSP_UNINITIALIZED;
+    }
+    if (v > 0) {
+        dispatch_buf_t buf;
+        if (!dispatch_alloc(&buf)) {
+            return ESP_ERR_NO_MEM;
+        }
+        bool valid = dispatch_check(op, &desc->variants[v].fn, &buf);
+        dispatch_free(&buf);
+        if (!valid) {
+            ESP_LOGW(TAG, "%s: %s differs from the ANSI reference", desc->op_name, variant);
+            return ESP_FAIL;
+        }
+    }
+    for (int c = first; c <= last; c++) {
+        dispatch_table[op][c] = desc->variants[v].fn;
+        dispatch_locked[op][c] = true;
+    }
+    return ESP_OK;
+}
+
+const char *dsps_dispatch_variant(dsps_dispatch_op_t op, int len)
+{
+    if ((op < 0) || (op >= DSPS_DISPATCH_OP_COUNT)) {
+        return NULL;
+    }
+    const dispatch_op_desc_t *desc = &dispatch_ops[op];
+    const dispatch_fn_t *fn = &dispatch_table[op][dispatch_class(len)];
+    for (int v = 0; v < desc->count; v++) {
+        if (dispatch_same(op, &desc->variants[v].fn, fn)) {
+            return desc->variants[v].name;
+        }
+    }
+    return NULL;
+}
+
+void dsps_dispatch_print(void)
+{
+    for (int op = 0; op < DSPS_DISPATCH_OP_COUNT; op++) {
+        for (int c = 0; c < DSPS_DISPATCH_SIZES; c++) {
+            printf("dsps_dispatch_override(%s, %i, \"%s\");\n", dispatch_ops[op].op_name, dispatch_bench_len[c],
+                   dsps_dispatch_variant(op, dispatch_bench_len[c]));
+        }
+    }
+}
+
+esp_err_t dsps_dotprod_f32_auto(const float *src1, const float *src2, float *dest, int len)
+{
+    return dispatch_table[DSPS_DISPATCH_DOTPROD_F32][dispatch_class(len)].dotprod(src1, src2, dest, len);
+}
+
+esp_err_t dsps_mul_f32_auto(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out)
+{
+    return dispatch_table[DSPS_DISPATCH_MUL_F32][dispatch_class(len)].vec(input1, input2, output, len, step1, step2, step_out);
+}
+
+esp_err_t dsps_add_f32_auto(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out)
+{
+    return dispatch_table[DSPS_DISPATCH_ADD_F32][dispatch_class(len)].vec(input1, input2, output, len, step1, step2, step_out);
+}
+
+esp_err_t dsps_biquad_f32_auto(const float *input, float *output, int len, float *coef, float *w)
+{
+    return dispatch_table[DSPS_DISPATCH_BIQUAD_F32][dispatch_class(len)].biquad(input, output, len, coef, w);
+}
+
+esp_err_t dsps_fft2r_fc32_auto(float *data, int N)
+{
+    return dispatch_table[DSPS_DISPATCH_FFT2R_FC32][dispatch_class(N)].fft(data, N, dsps_fft_w_table_fc32);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file test_dsps_dispatch.c
+ * @brief Tests of the runtime kernel dispatch table
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "esp_dsp.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_dispatch";
+
+static float x[1024];
+static float y[1024];
+static float z[1024];
+static float z_ansi[1024];
+
+TEST_CASE("dsps_dispatch functionality", "[dsps]")
+{
+    for (int i = 0 ; i < 1024 ; i++) {
+        x[i] = i * 0.25f - 7;
+        y[i] = 3 - i * 0.5f;
+    }
+    TEST_ESP_OK(dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE));
+    TEST_ESP_OK(dsps_dispatch_init());
+    dsps_dispatch_print();
+
+    // Every size class has a selection, whatever variant won
+    for (int op = 0; op < DSPS_DISPATCH_OP_COUNT; op++) {
+        for (int len = 16; len <= 1024; len <<= 2) {
+            TEST_ASSERT_NOT_NULL(dsps_dispatch_variant(op, len));
+        }
+    }
+    TEST_ESP_OK(dsps_mul_f32_auto(x, y, z, 1024, 1, 1, 1));
+    TEST_ESP_OK(dsps_mul_f32_ansi(x, y, z_ansi, 1024, 1, 1, 1));
+    TEST_ASSERT_EQUAL(0, memcmp(z, z_ansi, sizeof(z)));
+
+    // Override: all the size classes, then a single one
+    TEST_ESP_OK(dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 0, "ansi"));
+    TEST_ASSERT_EQUAL_STRING("ansi", dsps_dispatch_variant(DSPS_DISPATCH_BIQUAD_F32, 16));
+    TEST_ASSERT_EQUAL_STRING("ansi", dsps_dispatch_variant(DSPS_DISPATCH_BIQUAD_F32, 1024));
+    TEST_ESP_OK(dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 1024, "rv32"));
+    TEST_ASSERT_EQUAL_STRING("ansi", dsps_dispatch_variant(DSPS_DISPATCH_BIQUAD_F32, 256));
+    TEST_ASSERT_EQUAL_STRING("rv32", dsps_dispatch_variant(DSPS_DISPATCH_BIQUAD_F32, 300));
+    // Overridden operations are kept by dsps_dispatch_init()
+    TEST_ESP_OK(dsps_dispatch_init());
+    TEST_ASSERT_EQUAL_STRING("ansi", dsps_dispatch_variant(DSPS_DISPATCH_BIQUAD_F32, 16));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 0, "none"));
+    TEST_ESP_OK(dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 0, NULL));
+    // Locks are per size class: unlocking one class keeps the others
+    TEST_ESP_OK(dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 16, "rv32"));
+    TEST_ESP_OK(dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 1024, NULL));
+    TEST_ESP_OK(dsps_dispatch_init());
+    TEST_ASSERT_EQUAL_STRING("rv32", dsps_dispatch_variant(DSPS_DISPATCH_BIQUAD_F32, 16));
+    TEST_ESP_OK(dsps_dispatch_override(DSPS_DISPATCH_BIQUAD_F32, 0, NULL));
+
+    dsps_fft2r_deinit_fc32();
+    ESP_LOGI(TAG, "dispatch table checked");
+}
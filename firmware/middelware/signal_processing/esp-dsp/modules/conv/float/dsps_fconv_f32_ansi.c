@@ -0,0 +1,187 @@
+/**
+ * @file dsps_fconv_f32_ansi.c
+ * @brief Streaming convolution: direct or FFT overlap-save
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include <malloc.h>
+#include "dsps_fconv.h"
+#include "dsps_corr.h"
+#include "dsps_fft2r.h"
+#include "dsps_dispatch.h"
+#include "dsp_common.h"
+
+// Estimated floating point operations per output sample of the FFT method: two complex
+// FFTs (5 N log2(N) each), bit reversals and the spectrum product for two blocks
+static int fconv_fft_cost(int fft_len, int block_len)
+{
+    int log2n = dsp_power_of_two(fft_len);
+    return (10 * fft_len * log2n + 8 * fft_len) / (2 * block_len);
+}
+
+static esp_err_t fconv_init(fconv_f32_t *conv, const float *kernel, int kernlen, int block_len, dsps_fconv_method_t method, bool reverse)
+{
+    if ((NULL == conv) || (NULL == kernel)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((kernlen < 1) || (block_len < 1)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    memset(conv, 0, sizeof(fconv_f32_t));
+    conv->kernlen = kernlen;
+    conv->block_len = block_len;
+    conv->fft_len = 2;
+    while (conv->fft_len < block_len + kernlen - 1) {
+        conv->fft_len <<= 1;
+    }
+    bool fft_ready = dsps_fft2r_initialized && (conv->fft_len <= dsps_fft_w_table_size);
+    if (method == DSPS_FCONV_AUTO) {
+        // Direct: one MAC (2 flops) per tap and sample. Without a long enough fft2r
+        // table the direct method is used whatever the cost
+        method = (fft_ready && (fconv_fft_cost(conv->fft_len, block_len) < 2 * kernlen)) ? DSPS_FCONV_FFT : DSPS_FCONV_DIRECT;
+    }
+    conv->method = method;
+    if ((method == DSPS_FCONV_FFT) && !fft_ready) {
+        return ESP_ERR_DSP_UNINITIALIZED;
+    }
+
+    int N = conv->fft_len;
+    conv->segment = (float *)calloc(kernlen - 1 + 2 * block_len, sizeof(float));
+    if (method == DSPS_FCONV_FFT) {
+        conv->kernel = (float *)memalign(16, 2 * N * sizeof(float));
+        conv->fft_buff = (float *)memalign(16, 2 * N * sizeof(float));
+    } else {
+        conv->kernel = (float *)malloc(kernlen * sizeof(float));
+    }
+    if ((conv->segment == NULL) || (conv->kernel == NULL) || ((method == DSPS_FCONV_FFT) && (conv->fft_buff == NULL))) {
+        dsps_fconv_free_f32(conv);
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (method == DSPS_FCONV_DIRECT) {
+        // dsps_corr_f32() slides the kernel in time order: store the convolution kernel reversed
+        for (int k = 0; k < kernlen; k++) {
+            conv->kernel[k] = reverse ? kernel[k] : kernel[kernlen - 1 - k];
+        }
+        return ESP_OK;
+    }
+    // Spectrum of the zero padded convolution kernel, with the 1/N of the inverse FFT
+    memset(conv->kernel, 0, 2 * N * sizeof(float));
+    for (int k = 0; k < kernlen; k++) {
+        conv->kernel[2 * k] = (reverse ? kernel[kernlen - 1 - k] : kernel[k]) / N;
+    }
+    esp_err_t ret = dsps_fft2r_fc32_auto(conv->kernel, N);
+    if (ret == ESP_OK) {
+        ret = dsps_bit_rev_fc32(conv->kernel, N);
+    }
+    if (ret != ESP_OK) {
+        dsps_fconv_free_f32(conv);
+    }
+    return ret;
+}
+
+esp_err_t dsps_fconv_init_f32(fconv_f32_t *conv, const float *Kernel, int kernlen, int block_len, dsps_fconv_method_t method)
+{
+    return fconv_init(conv, Kernel, kernlen, block_len, method, false);
+}
+
+esp_err_t dsps_fcorr_init_f32(fconv_f32_t *conv, const float *Pattern, int patlen, int block_len, dsps_fconv_method_t method)
+{
+    return fconv_init(conv, Pattern, patlen, block_len, method, true);
+}
+
+// Overlap-save of one or two blocks: segment[0..kernlen - 1 + blocks * block_len)
+static void fconv_fft_blocks(fconv_f32_t *conv, float *output, int blocks)
+{
+    int N = conv->fft_len;
+    int L = conv->block_len;
+    int seg_len = conv->kernlen - 1 + L;
+    const float *s0 = conv->segment;
+    const float *s1 = conv->segment + L;
+    const float *h = conv->kernel;
+    float *z = conv->fft_buff;
+
+    // Block 0 in the real part, block 1 in the imaginary part: the kernel is real, so
+    // the two results stay in separate parts
+    for (int i = 0; i < seg_len; i++) {
+        z[2 * i] = s0[i];
+        z[2 * i + 1] = (blocks == 2) ? s1[i] : 0;
+    }
+    memset(&z[2 * seg_len], 0, 2 * (N - seg_len) * sizeof(float));
+    dsps_fft2r_fc32_auto(z, N);
+    dsps_bit_rev_fc32(z, N);
+    // Product with the kernel spectrum, conjugated: IFFT(X) = conj(FFT(conj(X))) / N
+    for (int i = 0; i < N; i++) {
+        float re = z[2 * i] * h[2 * i] - z[2 * i + 1] * h[2 * i + 1];
+        float im = z[2 * i] * h[2 * i + 1] + z[2 * i + 1] * h[2 * i];
+        z[2 * i] = re;
+        z[2 * i + 1] = -im;
+    }
+    dsps_fft2r_fc32_auto(z, N);
+    dsps_bit_rev_fc32(z, N);
+    // The first kernlen - 1 points are circular aliasing
+    const float *y = &z[2 * (conv->kernlen - 1)];
+    for (int i = 0; i < L; i++) {
+        output[i] = y[2 * i];
+    }
+    if (blocks == 2) {
+        for (int i = 0; i < L; i++) {
+            output[L + i] = -y[2 * i + 1];
+        }
+    }
+}
+
+esp_err_t dsps_fconv_f32(fconv_f32_t *conv, const float *input, float *output, int len)
+{
+    if ((NULL == conv) || (NULL == conv->segment) || (NULL == input) || (NULL == output)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((len < 0) || (len % conv->block_len != 0)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    int L = conv->block_len;
+    int history = conv->kernlen - 1;
+    esp_err_t ret = ESP_OK;
+    while ((len > 0) && (ret == ESP_OK)) {
+        int blocks = ((conv->method == DSPS_FCONV_FFT) && (len >= 2 * L)) ? 2 : 1;
+        memcpy(&conv->segment[history], input, blocks * L * sizeof(float));
+        if (conv->method == DSPS_FCONV_FFT) {
+            fconv_fft_blocks(conv, output, blocks);
+        } else {
+            ret = dsps_corr_f32(conv->segment, history + L, conv->kernel, conv->kernlen, output);
+        }
+        memmove(conv->segment, &conv->segment[blocks * L], history * sizeof(float));
+        input += blocks * L;
+        output += blocks * L;
+        len -= blocks * L;
+    }
+    return ret;
+}
+
+esp_err_t dsps_fconv_reset_f32(fconv_f32_t *conv)
+{
+    if ((NULL == conv) || (NULL == conv->segment)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    memset(conv->segment, 0, (conv->kernlen - 1) * sizeof(float));
+    return ESP_OK;
+}
+
+esp_err_t dsps_fconv_free_f32(fconv_f32_t *conv)
+{
+    if (NULL == conv) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    free(conv->kernel);
+    free(conv->fft_buff);
+    free(conv->segment);
+    conv->kernel = NULL;
+    conv->fft_buff = NULL;
+    conv->segment = NULL;
+    return ESP_OK;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file dsps_fconv.h
+ * @brief Streaming convolution: direct or FFT overlap-save
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _dsps_fconv_H_
+#define _dsps_fconv_H_
+#include <stdbool.h>
+#include "dsp_err.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Method of the streaming convolution
+ */
+typedef enum dsps_fconv_method_ {
+    DSPS_FCONV_AUTO,    /*!< Select by the cost estimate at init */
+    DSPS_FCONV_DIRECT,  /*!< Sliding dot product (dsps_corr_f32), kernlen MACs per sample */
+    DSPS_FCONV_FFT,     /*!< Overlap-save with the fft2r kernels */
+} dsps_fconv_method_t;
+
+/**
+ * @brief Data struct of the f32 streaming convolution/correlation
+ *
+ * This structure is used internally. A user should access this structure only to read
+ * the selected method and the FFT length.
+ * All fields of this structure are initialized by dsps_fconv_init_f32() or dsps_fcorr_init_f32().
+ */
+typedef struct fconv_f32_s {
+    float  *kernel;         /*!< Reversed kernel (direct) or kernel spectrum scaled by 1/fft_len (FFT).*/
+    float  *fft_buff;       /*!< FFT work buffer, 2 * fft_len.*/
+    float  *segment;        /*!< Last kernlen - 1 input samples followed by up to 2 blocks.*/
+    int     kernlen;        /*!< Kernel length.*/
+    int     block_len;      /*!< Samples per block.*/
+    int     fft_len;        /*!< Complex FFT length (FFT method).*/
+    dsps_fconv_method_t method; /*!< Selected method.*/
+} fconv_f32_t;
+
+/**@{*/
+/**
+ * @brief   Initialize a streaming convolution
+ *
+ * output[n] = sum(Kernel[k] * input[n - k]), k = [0..kernlen), with the input before the
+ * first sample taken as zero: the first samples of dsps_conv_f32() of the whole stream.
+ *
+ * The FFT method processes blocks with overlap-save on fft_len = 2^k >= block_len + kernlen - 1
+ * points. Two consecutive blocks share one complex FFT (one in the real part, the other in the
+ * imaginary part), so dsps_fconv_f32() calls with several blocks cost half per block.
+ * DSPS_FCONV_AUTO selects the FFT method when its estimated cost per sample is lower
+ * than kernlen MACs, typically for kernels longer than about 64 taps.
+ * The FFT method needs the fft2r table initialized (dsps_fft2r_init_fc32()) for fft_len:
+ * without it DSPS_FCONV_AUTO selects the direct method.
+ *
+ * @param conv: pointer to the structure, must be preallocated
+ * @param[in] Kernel: convolution kernel, copied (not used after init)
+ * @param[in] kernlen: kernel length
+ * @param[in] block_len: samples per block (for example the ADC callback length)
+ * @param[in] method: DSPS_FCONV_AUTO, DSPS_FCONV_DIRECT or DSPS_FCONV_FFT
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_UNINITIALIZED if DSPS_FCONV_FFT needs a longer fft2r table
+ *      - ESP_ERR_NO_MEM if the buffers can not be allocated
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_fconv_init_f32(fconv_f32_t *conv, const float *Kernel, int kernlen, int block_len, dsps_fconv_method_t method);
+
+/**
+ * @brief   Initialize a streaming correlation
+ *
+ * output[n] = sum(Pattern[k] * input[n - patlen + 1 + k]), k = [0..patlen): the correlation
+ * with the window ending at sample n, dsps_corr_f32() dest[n - patlen + 1].
+ * Same methods and parameters as dsps_fconv_init_f32().
+ */
+esp_err_t dsps_fcorr_init_f32(fconv_f32_t *conv, const float *Pattern, int patlen, int block_len, dsps_fconv_method_t method);
+
+/**
+ * @brief   Process blocks of the stream
+ *
+ * @param conv: structure initialized by dsps_fconv_init_f32() or dsps_fcorr_init_f32()
+ * @param[in] input: input samples
+ * @param output: output samples, may be the input array
+ * @param len: number of samples, multiple of block_len
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is not a multiple of block_len
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_fconv_f32(fconv_f32_t *conv, const float *input, float *output, int len);
+
+/**
+ * @brief   Clear the input history (start of a new stream)
+ */
+esp_err_t dsps_fconv_reset_f32(fconv_f32_t *conv);
+
+/**
+ * @brief   Free the buffers allocated by the init functions
+ */
+esp_err_t dsps_fconv_free_f32(fconv_f32_t *conv);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_fconv_H_
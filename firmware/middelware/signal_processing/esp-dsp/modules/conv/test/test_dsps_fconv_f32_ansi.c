@@ -0,0 +1,90 @@
+/**
+ * @file test_dsps_fconv_f32_ansi.c
+ * @brief Tests of the streaming convolution against dsps_conv_f32
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "esp_dsp.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_fconv";
+
+#define BLOCK_LEN   64
+#define SIG_LEN     (7 * BLOCK_LEN)
+#define MAX_KERNEL  300
+
+static float x[SIG_LEN];
+static float kernel[MAX_KERNEL];
+static float y[SIG_LEN];
+static float y_ref[SIG_LEN + MAX_KERNEL];
+
+static void test_fconv_stream(fconv_f32_t *conv)
+{
+    // 1 block, then 2 (one shared FFT), then 4 (two shared FFTs): 7 blocks
+    TEST_ESP_OK(dsps_fconv_f32(conv, x, y, BLOCK_LEN));
+    TEST_ESP_OK(dsps_fconv_f32(conv, &x[BLOCK_LEN], &y[BLOCK_LEN], 2 * BLOCK_LEN));
+    memcpy(&y[3 * BLOCK_LEN], &x[3 * BLOCK_LEN], 4 * BLOCK_LEN * sizeof(float));
+    TEST_ESP_OK(dsps_fconv_f32(conv, &y[3 * BLOCK_LEN], &y[3 * BLOCK_LEN], 4 * BLOCK_LEN));
+}
+
+TEST_CASE("dsps_fconv_f32 functionality", "[dsps]")
+{
+    const int kernel_len[] = {1, 5, 37, 100, MAX_KERNEL};
+    const dsps_fconv_method_t methods[] = {DSPS_FCONV_DIRECT, DSPS_FCONV_FFT, DSPS_FCONV_AUTO};
+    fconv_f32_t conv;
+
+    TEST_ESP_OK(dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE));
+    for (int i = 0; i < SIG_LEN; i++) {
+        x[i] = sinf(i * 0.05f) + 0.3f * cosf(i * 0.7f);
+    }
+    for (int i = 0; i < MAX_KERNEL; i++) {
+        kernel[i] = cosf(i * 0.1f) / (1 + i * 0.01f);
+    }
+    for (int k = 0; k < sizeof(kernel_len) / sizeof(kernel_len[0]); k++) {
+        int M = kernel_len[k];
+        for (int m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+            // Convolution: first SIG_LEN samples of the full convolution
+            TEST_ESP_OK(dsps_fconv_init_f32(&conv, kernel, M, BLOCK_LEN, methods[m]));
+            test_fconv_stream(&conv);
+            dsps_conv_f32_ansi(x, SIG_LEN, kernel, M, y_ref);
+            for (int i = 0; i < SIG_LEN; i++) {
+                TEST_ASSERT_FLOAT_WITHIN(1e-3f * (1 + fabsf(y_ref[i])), y_ref[i], y[i]);
+            }
+            TEST_ESP_OK(dsps_fconv_free_f32(&conv));
+
+            // Correlation: window ending at each sample
+            TEST_ESP_OK(dsps_fcorr_init_f32(&conv, kernel, M, BLOCK_LEN, methods[m]));
+            test_fconv_stream(&conv);
+            dsps_corr_f32_ansi(x, SIG_LEN, kernel, M, y_ref);
+            for (int i = M - 1; i < SIG_LEN; i++) {
+                TEST_ASSERT_FLOAT_WITHIN(1e-3f * (1 + fabsf(y_ref[i - M + 1])), y_ref[i - M + 1], y[i]);
+            }
+            TEST_ESP_OK(dsps_fconv_free_f32(&conv));
+        }
+    }
+    // Short kernels stay direct, long kernels go to the FFT
+    TEST_ESP_OK(dsps_fconv_init_f32(&conv, kernel, 5, BLOCK_LEN, DSPS_FCONV_AUTO));
+    TEST_ASSERT_EQUAL(DSPS_FCONV_DIRECT, conv.method);
+    dsps_fconv_free_f32(&conv);
+    TEST_ESP_OK(dsps_fconv_init_f32(&conv, kernel, MAX_KERNEL, BLOCK_LEN, DSPS_FCONV_AUTO));
+    TEST_ASSERT_EQUAL(DSPS_FCONV_FFT, conv.method);
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_fconv_f32(&conv, x, y, BLOCK_LEN + 1));
+    dsps_fconv_free_f32(&conv);
+    dsps_fft2r_deinit_fc32();
+    // Without the fft2r table AUTO falls back to direct, an explicit FFT fails
+    TEST_ESP_OK(dsps_fconv_init_f32(&conv, kernel, MAX_KERNEL, BLOCK_LEN, DSPS_FCONV_AUTO));
+    TEST_ASSERT_EQUAL(DSPS_FCONV_DIRECT, conv.method);
+    dsps_fconv_free_f32(&conv);
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_UNINITIALIZED, dsps_fconv_init_f32(&conv, kernel, MAX_KERNEL, BLOCK_LEN, DSPS_FCONV_FFT));
+    ESP_LOGI(TAG, "Streaming convolution and correlation match dsps_conv/dsps_corr");
+}
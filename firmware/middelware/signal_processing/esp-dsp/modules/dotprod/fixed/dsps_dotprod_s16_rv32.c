@@ -0,0 +1,41 @@
+/**
+ * @file dsps_dotprod_s16_rv32.c
+ * @brief Unrolled C 16 bits dot product for the RISC-V cores
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dsps_dotprod.h"
+
+esp_err_t dsps_dotprod_s16_rv32(const int16_t *src1, const int16_t *src2, int16_t *dest, int len, int8_t shift)
+{
+    // To make correct round operation we have to shift round value
+    long long acc = 0x7fff >> shift;
+    const int16_t *end4 = src1 + (len & ~3);
+    const int16_t *end = src1 + len;
+
+    // Every product goes straight into the 64-bit sum: two (-32768)^2
+    // products already overflow int32, so they cannot be paired first
+    while (src1 < end4) {
+        acc += (int32_t)src1[0] * src2[0];
+        acc += (int32_t)src1[1] * src2[1];
+        acc += (int32_t)src1[2] * src2[2];
+        acc += (int32_t)src1[3] * src2[3];
+        src1 += 4;
+        src2 += 4;
+    }
+    while (src1 < end) {
+        acc += (int32_t)*src1++ * *src2++;
+    }
+
+    int final_shift = shift - 15;
+    if (final_shift > 0) {
+        *dest = (acc << final_shift);
+    } else {
+        *dest = (acc >> (-final_shift));
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file dsps_dotprod_f32_rv32.c
+ * @brief Unrolled C float dot product for the RISC-V cores
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dsps_dotprod.h"
+
+// RV32IMAC has no FPU: every multiply-accumulate is a soft-float call, so the
+// gain comes from fewer loop branches and index computations per element.
+esp_err_t dsps_dotprod_f32_rv32(const float *src1, const float *src2, float *dest, int len)
+{
+    float acc0 = 0;
+    float acc1 = 0;
+    const float *end4 = src1 + (len & ~3);
+    const float *end = src1 + len;
+    while (src1 < end4) {
+        acc0 += src1[0] * src2[0];
+        acc1 += src1[1] * src2[1];
+        acc0 += src1[2] * src2[2];
+        acc1 += src1[3] * src2[3];
+        src1 += 4;
+        src2 += 4;
+    }
+    while (src1 < end) {
+        acc0 += *src1++ * *src2++;
+    }
+    *dest = acc0 + acc1;
+    return ESP_OK;
+}
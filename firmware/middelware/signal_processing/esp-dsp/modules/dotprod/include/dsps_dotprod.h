@@ -32,6 +32,7 @@ extern "C"
  * Dot product calculation for two signed 16 bit arrays: *dest += (src1[i] * src2[i]) >> (15-shift); i= [0..N)
  * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
  * The extension (_ae32) is optimized for ESP32 chip.
+ * The extension (_rv32) is optimized for RISC-V chips without FPU (ESP32-C6).
  *
  * @param[in] src1  source array 1
  * @param[in] src2  source array 2
@@ -44,6 +45,7 @@ extern "C"
  */
 esp_err_t dsps_dotprod_s16_ansi(const int16_t *src1, const int16_t *src2, int16_t *dest, int len, int8_t shift);
 esp_err_t dsps_dotprod_s16_ae32(const int16_t *src1, const int16_t *src2, int16_t *dest, int len, int8_t shift);
+esp_err_t dsps_dotprod_s16_rv32(const int16_t *src1, const int16_t *src2, int16_t *dest, int len, int8_t shift);
 /**@}*/
 
 
@@ -53,6 +55,7 @@ esp_err_t dsps_dotprod_s16_ae32(const int16_t *src1, const int16_t *src2, int16_
  * Dot product calculation for two floating point arrays: *dest += (src1[i] * src2[i]); i= [0..N)
  * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
  * The extension (_ae32) is optimized for ESP32 chip.
+ * The extension (_rv32) is optimized for RISC-V chips without FPU (ESP32-C6).
  *
  * @param[in] src1  source array 1
  * @param[in] src2  source array 2
@@ -65,6 +68,7 @@ esp_err_t dsps_dotprod_s16_ae32(const int16_t *src1, const int16_t *src2, int16_
 esp_err_t dsps_dotprod_f32_ansi(const float *src1, const float *src2, float *dest, int len);
 esp_err_t dsps_dotprod_f32_ae32(const float *src1, const float *src2, float *dest, int len);
 esp_err_t dsps_dotprod_f32_aes3(const float *src1, const float *src2, float *dest, int len);
+esp_err_t dsps_dotprod_f32_rv32(const float *src1, const float *src2, float *dest, int len);
 /**@}*/
 
 /**@{*/
@@ -96,6 +100,8 @@ esp_err_t dsps_dotprode_f32_ae32(const float *src1, const float *src2, float *de
 
 #if (dsps_dotprod_s16_ae32_enabled == 1)
 #define dsps_dotprod_s16 dsps_dotprod_s16_ae32
+#elif (dsps_dotprod_s16_rv32_enabled == 1)
+#define dsps_dotprod_s16 dsps_dotprod_s16_rv32
 #else
 #define dsps_dotprod_s16 dsps_dotprod_s16_ansi
 #endif // dsps_dotprod_s16_ae32_enabled
@@ -106,6 +112,9 @@ esp_err_t dsps_dotprode_f32_ae32(const float *src1, const float *src2, float *de
 #elif (dotprod_f32_ae32_enabled == 1)
 #define dsps_dotprod_f32 dsps_dotprod_f32_ae32
 #define dsps_dotprode_f32 dsps_dotprode_f32_ae32
+#elif (dsps_dotprod_f32_rv32_enabled == 1)
+#define dsps_dotprod_f32 dsps_dotprod_f32_rv32
+#define dsps_dotprode_f32 dsps_dotprode_f32_ansi
 #else
 #define dsps_dotprod_f32 dsps_dotprod_f32_ansi
 #define dsps_dotprode_f32 dsps_dotprode_f32_ansi
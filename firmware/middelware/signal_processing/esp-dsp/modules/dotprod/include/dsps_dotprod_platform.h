@@ -29,4 +29,10 @@
 #endif
 
 
+#ifdef __riscv
+// RV32IMAC (ESP32-C6): C kernels with unrolled, pointer-increment loops
+#define dsps_dotprod_f32_rv32_enabled 1
+#define dsps_dotprod_s16_rv32_enabled 1
+#endif // __riscv
+
 #endif // _dsps_dotprod_platform_H_
@@ -0,0 +1,66 @@
+/**
+ * @file test_dotprod_rv32.c
+ * @brief Tests of the _rv32 dot products against the ANSI reference
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+#include <malloc.h>
+
+#include "dsps_dotprod.h"
+#include "dsp_tests.h"
+
+TEST_CASE("dsps_dotprod_f32_rv32 functionality", "[dsps]")
+{
+    int max_N = 1024;
+    float *x = (float *)memalign(16, max_N * sizeof(float));
+    float *y = (float *)memalign(16, max_N * sizeof(float));
+    for (int i = 0 ; i < max_N ; i++) {
+        x[i] = sinf(i * 0.1f);
+        y[i] = (i % 7) - 3;
+    }
+    for (int len = 0 ; len < 37 ; len++) {
+        float result = -1;
+        float expected = -1;
+        dsps_dotprod_f32_rv32(x, y, &result, len);
+        dsps_dotprod_f32_ansi(x, y, &expected, len);
+        // Two accumulators: summation order differs from the ANSI loop
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, expected, result);
+    }
+    float result = 0;
+    float expected = 0;
+    dsps_dotprod_f32_rv32(x, y, &result, max_N);
+    dsps_dotprod_f32_ansi(x, y, &expected, max_N);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, expected, result);
+    free(x);
+    free(y);
+}
+
+TEST_CASE("dsps_dotprod_s16_rv32 functionality", "[dsps]")
+{
+    int max_N = 1024;
+    int16_t *x = (int16_t *)memalign(16, max_N * sizeof(int16_t));
+    int16_t *y = (int16_t *)memalign(16, max_N * sizeof(int16_t));
+    for (int i = 0 ; i < max_N ; i++) {
+        x[i] = (i & 1) ? -32768 : (int16_t)(i * 37);
+        y[i] = (i & 1) ? -32768 : (int16_t)(1000 - i * 13);
+    }
+    for (int len = 1 ; len < max_N ; len += 13) {
+        for (int shift = 0 ; shift < 16 ; shift += 5) {
+            int16_t result = 0;
+            int16_t expected = 0;
+            dsps_dotprod_s16_rv32(x, y, &result, len, shift);
+            dsps_dotprod_s16_ansi(x, y, &expected, len, shift);
+            TEST_ASSERT_EQUAL(expected, result);
+        }
+    }
+    free(x);
+    free(y);
+}
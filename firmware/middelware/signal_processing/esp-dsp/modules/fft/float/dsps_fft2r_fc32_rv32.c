@@ -0,0 +1,60 @@
+/**
+ * @file dsps_fft2r_fc32_rv32.c
+ * @brief Radix-2 complex FFT butterflies for the RISC-V cores
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dsps_fft2r.h"
+#include "dsp_common.h"
+#include "dsp_types.h"
+
+// Butterflies only: the twiddle table, dsps_fft2r_init_fc32() and the bit
+// reversal are shared with the ANSI implementation.
+esp_err_t dsps_fft2r_fc32_rv32_(float *data, int N, float *w)
+{
+    if (!dsp_is_power_of_two(N)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    if (!dsps_fft2r_initialized) {
+        return ESP_ERR_DSP_UNINITIALIZED;
+    }
+
+    int ie = 1;
+    for (int N2 = N / 2; N2 > 0; N2 >>= 1) {
+        float *top = data;
+        // First group of every stage: w = 1 + 0j, no multiplications.
+        // Saves four soft-float multiplies on about N of the N/2*log2(N) butterflies.
+        float *bot = top + 2 * N2;
+        for (float *end = bot; top < end; top += 2, bot += 2) {
+            float re = bot[0];
+            float im = bot[1];
+            bot[0] = top[0] - re;
+            bot[1] = top[1] - im;
+            top[0] = top[0] + re;
+            top[1] = top[1] + im;
+        }
+        top = bot;
+        const float *tw = w + 2;
+        for (int j = 1; j < ie; j++) {
+            float c = tw[0];
+            float s = tw[1];
+            tw += 2;
+            bot = top + 2 * N2;
+            for (float *end = bot; top < end; top += 2, bot += 2) {
+                float re = c * bot[0] + s * bot[1];
+                float im = c * bot[1] - s * bot[0];
+                bot[0] = top[0] - re;
+                bot[1] = top[1] - im;
+                top[0] = top[0] + re;
+                top[1] = top[1] + im;
+            }
+            top = bot;
+        }
+        ie <<= 1;
+    }
+    return ESP_OK;
+}
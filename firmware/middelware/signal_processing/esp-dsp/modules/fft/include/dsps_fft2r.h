@@ -81,6 +81,7 @@ void dsps_fft2r_deinit_sc16(void);
  * Complex FFT of radix 2
  * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
  * The extension (_ae32) is optimized for ESP32 chip.
+ * The extension (_rv32) is optimized for RISC-V chips without FPU (ESP32-C6).
  *
  * @param[inout] data: input/output complex array. An elements located: Re[0], Im[0], ... Re[N-1], Im[N-1]
  *               result of FFT will be stored to this array.
@@ -94,6 +95,7 @@ void dsps_fft2r_deinit_sc16(void);
 esp_err_t dsps_fft2r_fc32_ansi_(float *data, int N, float *w);
 esp_err_t dsps_fft2r_fc32_ae32_(float *data, int N, float *w);
 esp_err_t dsps_fft2r_fc32_aes3_(float *data, int N, float *w);
+esp_err_t dsps_fft2r_fc32_rv32_(float *data, int N, float *w);
 esp_err_t dsps_fft2r_sc16_ansi_(int16_t *data, int N, int16_t *w);
 esp_err_t dsps_fft2r_sc16_ae32_(int16_t *data, int N, int16_t *w);
 esp_err_t dsps_fft2r_sc16_aes3_(int16_t *data, int N, int16_t *w);
@@ -102,6 +104,7 @@ esp_err_t dsps_fft2r_sc16_aes3_(int16_t *data, int N, int16_t *w);
 // direct access to the table pointer
 #define dsps_fft2r_fc32_ae32(data, N) dsps_fft2r_fc32_ae32_(data, N, dsps_fft_w_table_fc32)
 #define dsps_fft2r_fc32_aes3(data, N) dsps_fft2r_fc32_aes3_(data, N, dsps_fft_w_table_fc32)
+#define dsps_fft2r_fc32_rv32(data, N) dsps_fft2r_fc32_rv32_(data, N, dsps_fft_w_table_fc32)
 #define dsps_fft2r_sc16_ae32(data, N) dsps_fft2r_sc16_ae32_(data, N, dsps_fft_w_table_sc16)
 #define dsps_fft2r_sc16_aes3(data, N) dsps_fft2r_sc16_aes3_(data, N, dsps_fft_w_table_sc16)
 #define dsps_fft2r_fc32_ansi(data, N) dsps_fft2r_fc32_ansi_(data, N, dsps_fft_w_table_fc32)
@@ -210,6 +213,8 @@ esp_err_t dsps_gen_bitrev2r_table(int N, int step, char *name_ext);
 #define dsps_fft2r_fc32 dsps_fft2r_fc32_aes3
 #elif (dsps_fft2r_fc32_ae32_enabled == 1)
 #define dsps_fft2r_fc32 dsps_fft2r_fc32_ae32
+#elif (dsps_fft2r_fc32_rv32_enabled == 1)
+#define dsps_fft2r_fc32 dsps_fft2r_fc32_rv32
 #else
 #define dsps_fft2r_fc32 dsps_fft2r_fc32_ansi
 #endif
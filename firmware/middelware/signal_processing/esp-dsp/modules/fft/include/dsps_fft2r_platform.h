@@ -33,4 +33,9 @@
 #endif
 
 
+#ifdef __riscv
+// RV32IMAC (ESP32-C6): C kernels with unrolled, pointer-increment loops
+#define dsps_fft2r_fc32_rv32_enabled 1
+#endif // __riscv
+
 #endif // _dsps_fft2r_platform_H_
@@ -154,13 +154,14 @@ esp_err_t dsps_gen_bitrev4r_table(int N, int step, char *name_ext);
 #if CONFIG_DSP_OPTIMIZED
 #if (dsps_fft4r_fc32_ae32_enabled == 1)
 #define dsps_fft4r_fc32 dsps_fft4r_fc32_ae32
+#define dsps_fft4r_sc16 dsps_fft4r_sc16_ae32
+#define dsps_bit_rev4r_fc32 dsps_bit_rev4r_fc32_ae32
 #else
 #define dsps_fft4r_fc32 dsps_fft4r_fc32_ansi
+#define dsps_fft4r_sc16 dsps_fft4r_sc16_ansi
+#define dsps_bit_rev4r_fc32 dsps_bit_rev4r_fc32
 #endif // dsps_fft4r_fc32_ae32_enabled
 
-#define dsps_fft4r_sc16 dsps_fft4r_sc16_ae32
-#define dsps_bit_rev4r_fc32 dsps_bit_rev4r_fc32_ae32
-
 #if (dsps_cplx2real_fc32_ae32_enabled == 1)
 #define dsps_cplx2real_fc32 dsps_cplx2real_fc32_ae32
 #else
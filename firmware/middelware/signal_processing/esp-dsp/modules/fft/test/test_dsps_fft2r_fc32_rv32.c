@@ -0,0 +1,57 @@
+/**
+ * @file test_dsps_fft2r_fc32_rv32.c
+ * @brief Tests of dsps_fft2r_fc32_rv32 against the ANSI reference
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "dsp_common.h"
+#include "esp_log.h"
+
+#include "dsps_fft2r.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_fft2r_rv32";
+
+TEST_CASE("dsps_fft2r_fc32_rv32 functionality", "[dsps]")
+{
+    int N = 1024;
+    float *data = (float *)malloc(2 * N * sizeof(float));
+    float *check_data = (float *)malloc(2 * N * sizeof(float));
+
+    esp_err_t ret = dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    TEST_ESP_OK(ret);
+
+    for (int len = 16 ; len <= N ; len <<= 2) {
+        for (int i = 0 ; i < len ; i++) {
+            data[i * 2 + 0] = sinf(M_PI / len * 5 * 2 * i) + 0.1f * i / len;
+            data[i * 2 + 1] = cosf(i * 0.7f);
+        }
+        memcpy(check_data, data, 2 * len * sizeof(float));
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        TEST_ESP_OK(dsps_fft2r_fc32_rv32(data, len));
+        unsigned int end_b = dsp_get_cpu_cycle_count();
+        TEST_ESP_OK(dsps_fft2r_fc32_ansi(check_data, len));
+        unsigned int end_ansi = dsp_get_cpu_cycle_count();
+
+        // Same butterflies in the same order: results are bit exact
+        for (int i = 0 ; i < len * 2 ; i++) {
+            if (data[i] != check_data[i]) {
+                TEST_ASSERT_EQUAL(check_data[i], data[i]);
+            }
+        }
+        ESP_LOGI(TAG, "N = %4i: rv32 %u cycles, ansi %u cycles", len, end_b - start_b, end_ansi - end_b);
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_fft2r_fc32_rv32(data, 100));
+    dsps_fft2r_deinit_fc32();
+    free(data);
+    free(check_data);
+}
@@ -0,0 +1,49 @@
+/**
+ * @file dsps_fir_f32_rv32.c
+ * @brief Unrolled C float FIR filter for the RISC-V cores
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dsps_fir.h"
+
+static inline float dsps_fir_f32_rv32_mac(const float *coeffs, const float *delay, int count, float acc)
+{
+    const float *end4 = delay + (count & ~3);
+    const float *end = delay + count;
+    while (delay < end4) {
+        acc += coeffs[0] * delay[0];
+        acc += coeffs[1] * delay[1];
+        acc += coeffs[2] * delay[2];
+        acc += coeffs[3] * delay[3];
+        coeffs += 4;
+        delay += 4;
+    }
+    while (delay < end) {
+        acc += *coeffs++ * *delay++;
+    }
+    return acc;
+}
+
+esp_err_t dsps_fir_f32_rv32(fir_f32_t *fir, const float *input, float *output, int len)
+{
+    float *coeffs = fir->coeffs;
+    float *delay = fir->delay;
+    int N = fir->N;
+    int pos = fir->pos;
+    for (int i = 0 ; i < len ; i++) {
+        delay[pos] = input[i];
+        pos++;
+        if (pos >= N) {
+            pos = 0;
+        }
+        // Oldest sample first: same summation order as the ANSI version
+        float acc = dsps_fir_f32_rv32_mac(coeffs, delay + pos, N - pos, 0);
+        output[i] = dsps_fir_f32_rv32_mac(coeffs + N - pos, delay, pos, acc);
+    }
+    fir->pos = pos;
+    return ESP_OK;
+}
@@ -28,4 +28,9 @@
 #endif //
 #endif // __XTENSA__
 
+#ifdef __riscv
+// RV32IMAC (ESP32-C6): C kernels with unrolled, pointer-increment loops
+#define dsps_fir_f32_rv32_enabled 1
+#endif // __riscv
+
 #endif // _dsps_fir_platform_H_
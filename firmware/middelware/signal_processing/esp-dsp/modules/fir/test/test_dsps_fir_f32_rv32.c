@@ -0,0 +1,79 @@
+/**
+ * @file test_dsps_fir_f32_rv32.c
+ * @brief Tests of dsps_fir_f32_rv32 against the ANSI reference
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "dsp_common.h"
+#include "esp_log.h"
+
+#include "dsps_fir.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_fir_f32_rv32";
+
+static float x[1024];
+static float y[1024];
+static float y_compare[1024];
+static float coeffs[31];
+static float delay[31];
+static float delay_compare[31];
+
+TEST_CASE("dsps_fir_f32_rv32 functionality", "[dsps]")
+{
+    int len = sizeof(x) / sizeof(float);
+    // Odd filter length: both delay line segments have an unroll tail
+    int fir_len = sizeof(coeffs) / sizeof(float);
+
+    fir_f32_t fir1;
+    fir_f32_t fir2;
+    for (int i = 0 ; i < fir_len ; i++) {
+        coeffs[i] = sinf(i * 0.3f);
+    }
+    for (int i = 0 ; i < len ; i++) {
+        x[i] = cosf(i * 0.05f);
+    }
+    dsps_fir_init_f32(&fir1, coeffs, delay, fir_len);
+    dsps_fir_init_f32(&fir2, coeffs, delay_compare, fir_len);
+
+    // Odd block lengths move the delay line position around
+    for (int n = 0 ; n < 3 ; n++) {
+        int block = len - 7 * n;
+        dsps_fir_f32_rv32(&fir1, x, y, block);
+        dsps_fir_f32_ansi(&fir2, x, y_compare, block);
+        TEST_ASSERT_EQUAL(fir2.pos, fir1.pos);
+        for (int i = 0 ; i < block ; i++) {
+            if (y[i] != y_compare[i]) {
+                TEST_ASSERT_EQUAL(y[i], y_compare[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("dsps_fir_f32_rv32 benchmark", "[dsps]")
+{
+    int len = sizeof(x) / sizeof(float);
+    int fir_len = sizeof(coeffs) / sizeof(float);
+
+    fir_f32_t fir1;
+    dsps_fir_init_f32(&fir1, coeffs, delay, fir_len);
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_fir_f32_rv32(&fir1, x, y, len);
+    float cycles = (float)(dsp_get_cpu_cycle_count() - start_b) / len;
+
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_fir_f32_ansi(&fir1, x, y, len);
+    float cycles_ansi = (float)(dsp_get_cpu_cycle_count() - start_b) / len;
+
+    ESP_LOGI(TAG, "dsps_fir_f32_rv32 - %f per sample for %i coefficients, %f per tap", cycles, fir_len, cycles / (float)fir_len);
+    ESP_LOGI(TAG, "dsps_fir_f32_ansi - %f per sample for %i coefficients, %f per tap", cycles_ansi, fir_len, cycles_ansi / (float)fir_len);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file dsps_biquad_f32_rv32.c
+ * @brief Float biquad filter for the RISC-V cores
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dsps_biquad.h"
+
+esp_err_t dsps_biquad_f32_rv32(const float *input, float *output, int len, float *coef, float *w)
+{
+    // Coefficients and state held in registers: the ANSI loop reloads them
+    // after every output store because output may alias coef or w
+    const float b0 = coef[0];
+    const float b1 = coef[1];
+    const float b2 = coef[2];
+    const float a1 = coef[3];
+    const float a2 = coef[4];
+    float w0 = w[0];
+    float w1 = w[1];
+    const float *end2 = input + (len & ~1);
+    const float *end = input + len;
+
+    while (input < end2) {
+        float d0 = input[0] - a1 * w0 - a2 * w1;
+        output[0] = b0 * d0 + b1 * w0 + b2 * w1;
+        float d1 = input[1] - a1 * d0 - a2 * w0;
+        output[1] = b0 * d1 + b1 * d0 + b2 * w0;
+        w1 = d0;
+        w0 = d1;
+        input += 2;
+        output += 2;
+    }
+    if (input < end) {
+        float d0 = *input - a1 * w0 - a2 * w1;
+        *output = b0 * d0 + b1 * w0 + b2 * w1;
+        w1 = w0;
+        w0 = d0;
+    }
+    w[0] = w0;
+    w[1] = w1;
+    return ESP_OK;
+}
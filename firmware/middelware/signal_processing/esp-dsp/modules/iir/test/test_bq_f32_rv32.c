@@ -0,0 +1,87 @@
+/**
+ * @file test_bq_f32_rv32.c
+ * @brief Tests of dsps_biquad_f32_rv32 against the ANSI reference
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "dsp_common.h"
+#include "esp_log.h"
+
+#include "dsps_d_gen.h"
+#include "dsps_biquad_gen.h"
+#include "dsps_biquad.h"
+
+static const char *TAG = "dsps_biquad_f32_rv32";
+static const int bq_rv32_len = 1023;
+
+TEST_CASE("dsps_biquad_f32_rv32 functionality", "[dsps]")
+{
+    float *x = calloc(bq_rv32_len, sizeof(float));
+    float *y = calloc(bq_rv32_len, sizeof(float));
+    float *z = calloc(bq_rv32_len, sizeof(float));
+
+    // Odd length: covers the unrolled loop and the tail
+    int len = bq_rv32_len;
+    dsps_d_gen_f32(x, len, 0);
+    float coeffs[5];
+    float w1[2] = {0};
+    float w2[2] = {0};
+    dsps_biquad_gen_lpf_f32(coeffs, 0.1, 1);
+    for (int n = 0 ; n < 2 ; n++) {
+        dsps_biquad_f32_rv32(x, y, len, coeffs, w1);
+        dsps_biquad_f32_ansi(x, z, len, coeffs, w2);
+        for (int i = 0 ; i < len ; i++) {
+            if (y[i] != z[i]) {
+                TEST_ASSERT_EQUAL(y[i], z[i]);
+            }
+        }
+        TEST_ASSERT_EQUAL(w1[0], w2[0]);
+        TEST_ASSERT_EQUAL(w1[1], w2[1]);
+    }
+    // In place
+    memcpy(y, x, len * sizeof(float));
+    w1[0] = w2[0] = w1[1] = w2[1] = 0;
+    dsps_biquad_f32_rv32(y, y, len, coeffs, w1);
+    dsps_biquad_f32_ansi(x, z, len, coeffs, w2);
+    TEST_ASSERT_EQUAL(0, memcmp(y, z, len * sizeof(float)));
+    free(x);
+    free(y);
+    free(z);
+}
+
+TEST_CASE("dsps_biquad_f32_rv32 benchmark", "[dsps]")
+{
+    float *x = calloc(bq_rv32_len, sizeof(float));
+    float *y = calloc(bq_rv32_len, sizeof(float));
+
+    float w1[2] = {0};
+    int len = bq_rv32_len;
+    int repeat_count = 16;
+    dsps_d_gen_f32(x, len, 0);
+    float coeffs[5];
+    dsps_biquad_gen_lpf_f32(coeffs, 0.1, 1);
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0 ; i < repeat_count ; i++) {
+        dsps_biquad_f32_rv32(x, y, len, coeffs, w1);
+    }
+    float cycles = (float)(dsp_get_cpu_cycle_count() - start_b) / (len * repeat_count);
+
+    start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0 ; i < repeat_count ; i++) {
+        dsps_biquad_f32_ansi(x, y, len, coeffs, w1);
+    }
+    float cycles_ansi = (float)(dsp_get_cpu_cycle_count() - start_b) / (len * repeat_count);
+
+    ESP_LOGI(TAG, "dsps_biquad_f32_rv32 - %f per sample", cycles);
+    ESP_LOGI(TAG, "dsps_biquad_f32_ansi - %f per sample", cycles_ansi);
+    free(x);
+    free(y);
+}
@@ -14,6 +14,7 @@
 
 #include "ekf.h"
 #include <float.h>
+#include "esp_log.h"
 
 ekf::ekf(int x, int w) : NUMX(x),
     NUMW(w),
@@ -138,11 +139,16 @@ dspm::Mat ekf::qProduct(float *q)
 void ekf::CovariancePrediction(float dt)
 {
     dspm::Mat f = this->F * dt;
+    for (int i = 0; i < this->NUMX; i++) {
+        f(i, i) += 1;
+    }
 
-    f = f + dspm::Mat::eye(this->NUMX);
-
-    dspm::Mat f_t = f.t();
-    this->P = ((f * this->P) * f_t) + (dt * dt) * ((G * Q) * G.t());
+    // P = f*P*f' + dt^2 * G*Q*G'
+    dspm::Mat P_next(this->NUMX, this->NUMX);
+    dspm::Mat row(1, this->NUMX > this->NUMW ? this->NUMX : this->NUMW);
+    dspm::Mat::quadratic_form_sym(f, this->P, P_next, 1, 0, row.data);
+    dspm::Mat::quadratic_form_sym(this->G, this->Q, P_next, dt * dt, 1, row.data);
+    this->P = P_next;
 }
 
 void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
@@ -187,15 +193,21 @@ void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
 
 void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
 {
-    dspm::Mat h_t = H.t();
-    dspm::Mat S = H * P * h_t; // +diag(R);
+    dspm::Mat S(H.rows, H.rows);
+    dspm::Mat::quadratic_form_sym(H, P, S); // +diag(R);
     for (size_t i = 0; i < H.rows; i++) {
         S(i, i) += R[i];
     }
 
-    dspm::Mat S_ = S.pinv(); // 1 / S
-
-    dspm::Mat K = (P * h_t) * S_;
+    // K = P*H'*inv(S): S and P are symmetric, so K' = inv(S)*(H*P) by Cholesky
+    dspm::Mat Kt(H.rows, this->NUMX);
+    dspm::Mat::mult_transB(H, P, Kt);
+    if (!S.cholesky()) {
+        ESP_LOGW("ekf", "UpdateRef: innovation covariance is not positive-definite");
+        return;
+    }
+    S.choleskySolve(Kt);
+    dspm::Mat K = Kt.t();
     this->P = (dspm::Mat::eye(this->NUMX) - K * H) * P;
 
     dspm::Mat Y(measured, H.rows, 1);
@@ -410,6 +422,7 @@ dspm::Mat ekf::dFdq_inv(dspm::Mat &vector, dspm::Mat &q)
 dspm::Mat ekf::StateXdot(dspm::Mat &x, float *u)
 {
     dspm::Mat U(u, this->G.cols, 1);
-    dspm::Mat Xdot = (this->F * x + this->G * U);
+    dspm::Mat Xdot = this->F * x;
+    dspm::Mat::mult_add(this->G, U, Xdot, Xdot);
     return Xdot;
 }
@@ -124,7 +124,8 @@ public:
 
     /**
      * Calculates covariance prediction matrux P.
-     * Update matrix P
+     * Update matrix P. P is symmetric: only the upper triangle is computed and mirrored,
+     * and the zero elements of F and G are skipped.
      * @param[in] dt: time interval from last update
      */
     virtual void CovariancePrediction(float dt);
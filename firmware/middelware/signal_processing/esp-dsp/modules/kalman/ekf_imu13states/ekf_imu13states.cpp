@@ -100,6 +100,21 @@ void ekf_imu13states::LinearizeFG(dspm::Mat &x, float *u)
     G.Copy(dspm::Mat::eye(3), 10, 15); // random noise offset constant
 }
 
+void ekf_imu13states::CovariancePrediction(float dt)
+{
+    // f = I + F*dt
+    this->f = this->F;
+    this->f *= dt;
+    for (int i = 0; i < NX; i++) {
+        this->f(i, i) += 1;
+    }
+
+    // P = f*P*f' + dt^2 * G*Q*G'
+    dspm::Mat::quadratic_form_sym(this->f, this->P, this->fP, 1, 0, this->row);
+    dspm::Mat::quadratic_form_sym(this->G, this->Q, this->fP, dt * dt, 1, this->row);
+    this->P = this->fP;
+}
+
 void ekf_imu13states::Test()
 {
     dspm::Mat test_x(7, 1);
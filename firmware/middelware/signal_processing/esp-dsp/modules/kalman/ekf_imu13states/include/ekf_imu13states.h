@@ -16,6 +16,7 @@
 #define _ekf_imu13states_H_
 
 #include "ekf.h"
+#include "matn.h"
 
 /**
 * @brief This class is used to process and calculate attitude from imu sensors.
@@ -39,6 +40,17 @@ public:
     virtual dspm::Mat StateXdot(dspm::Mat &x, float *u);
     virtual void LinearizeFG(dspm::Mat &x, float *u);
 
+    /**
+     * Covariance prediction with fixed-size work matrices (no heap allocations).
+     * Same result as ekf::CovariancePrediction: upper triangle only, and the sparse
+     * F (rows 4..12 of I + F*dt are identity rows) and G are mostly skipped.
+     * @param[in] dt: time interval from last update
+     */
+    virtual void CovariancePrediction(float dt);
+
+    static const int NX = 13;   /*!< Number of states*/
+    static const int NW = 18;   /*!< Number of noise inputs*/
+
     /**
     *     Method for development and tests only.
     */
@@ -93,6 +105,11 @@ public:
      */
     void UpdateRefMeasurement(float *accel_data, float *magn_data, float *attitude, float R[10]);
 
+private:
+    // Work matrices of CovariancePrediction
+    dspm::MatN<NX, NX> f;
+    dspm::MatN<NX, NX> fP;
+    float row[NW];
 };
 
 #endif // _ekf_imu13states_H_
@@ -15,6 +15,7 @@
 #include <string.h>
 #include "unity.h"
 #include "dsp_platform.h"
+#include "dsp_common.h"
 #include "esp_log.h"
 
 #include "ekf_imu13states.h"
@@ -58,3 +59,47 @@ TEST_CASE("ekf_imu13states functionality gyro and magn", "[dspm]")
     printf("Expected result = %i, calculated result = %i\n", 200, (int)(1000 * ekf13->X.data[5] + 0.5));
     printf("Expected result = %i, calculated result = %i\n", 300, (int)(1000 * ekf13->X.data[6] + 0.5));
 }
+
+TEST_CASE("ekf_imu13states covariance prediction benchmark", "[dspm]")
+{
+    ekf_imu13states *ekf13 = new  ekf_imu13states();
+    ekf13->Init();
+    float q[4] = {0.9, 0.3, -0.2, 0.2};
+    float gyro[3] = {0.1, -0.2, 0.3};
+    float dt = 0.01;
+    memcpy(ekf13->X.data, q, sizeof(q));
+    ekf13->X.data[7] = 0.3;
+    for (int i = 0; i < ekf13->NUMX; i++) {
+        for (int j = 0; j < ekf13->NUMX; j++) {
+            ekf13->P(i, j) = (i == j) ? 1 : 0.01 * (i + j);
+        }
+    }
+    ekf13->LinearizeFG(ekf13->X, gyro);
+    dspm::Mat P0 = ekf13->P;
+
+    // Multiply-accumulates: dense f*P*f' + G*Q*G' against the symmetric, sparse version
+    int n = ekf13->NUMX;
+    int w = ekf13->NUMW;
+    int dense_macs = 2 * n * n * n + n * w * w + n * w * n;
+    dspm::Mat f = ekf13->F * dt;
+    for (int i = 0; i < n; i++) {
+        f(i, i) += 1;
+    }
+    dspm::Mat P_next(n, n);
+    int sym_macs = dspm::Mat::quadratic_form_sym(f, ekf13->P, P_next);
+    sym_macs += dspm::Mat::quadratic_form_sym(ekf13->G, ekf13->Q, P_next, dt * dt, 1);
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dspm::Mat P_dense = ((f * P0) * f.t()) + (dt * dt) * ((ekf13->G * ekf13->Q) * ekf13->G.t());
+    unsigned int dense_cycles = dsp_get_cpu_cycle_count() - start_b;
+    start_b = dsp_get_cpu_cycle_count();
+    ekf13->CovariancePrediction(dt);
+    unsigned int sym_cycles = dsp_get_cpu_cycle_count() - start_b;
+
+    ESP_LOGI(TAG, "Prediction: dense %i MACs %u cycles, symmetric %i MACs %u cycles", dense_macs, dense_cycles, sym_macs, sym_cycles);
+    for (int i = 0; i < n * n; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, P_dense.data[i], ekf13->P.data[i]);
+    }
+    TEST_ASSERT_LESS_THAN(dense_macs / 2, sym_macs);
+    delete ekf13;
+}
@@ -47,6 +47,7 @@ extern "C"
  */
 esp_err_t dsps_add_f32_ansi(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
 esp_err_t dsps_add_f32_ae32(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
+esp_err_t dsps_add_f32_rv32(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
 
 esp_err_t dsps_add_s16_ansi(const int16_t *input1, const int16_t *input2, int16_t *output, int len, int step1, int step2, int step_out, int shift);
 esp_err_t dsps_add_s16_ae32(const int16_t *input1, const int16_t *input2, int16_t *output, int len, int step1, int step2, int step_out, int shift);
@@ -65,6 +66,8 @@ esp_err_t dsps_add_s8_aes3(const int8_t *input1, const int8_t *input2, int8_t *o
 
 #if (dsps_add_f32_ae32_enabled == 1)
 #define dsps_add_f32 dsps_add_f32_ae32
+#elif (dsps_add_f32_rv32_enabled == 1)
+#define dsps_add_f32 dsps_add_f32_rv32
 #else
 #define dsps_add_f32 dsps_add_f32_ansi
 #endif
@@ -29,4 +29,9 @@
 #endif // __XTENSA__
 
 
+#ifdef __riscv
+// RV32IMAC (ESP32-C6): C kernels with unrolled, pointer-increment loops
+#define dsps_add_f32_rv32_enabled 1
+#endif // __riscv
+
 #endif // _dsps_add_platform_H_
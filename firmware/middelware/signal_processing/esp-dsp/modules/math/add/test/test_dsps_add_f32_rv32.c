@@ -0,0 +1,39 @@
+/**
+ * @file test_dsps_add_f32_rv32.c
+ * @brief Tests of dsps_add_f32_rv32 against the ANSI reference
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_add.h"
+#include "dsp_tests.h"
+
+static float x[1027];
+static float y[1027];
+static float z[1027];
+static float z_ansi[1027];
+
+TEST_CASE("dsps_add_f32_rv32 functionality", "[dsps]")
+{
+    int n = sizeof(x) / sizeof(float);
+    for (int i = 0 ; i < n ; i++) {
+        x[i] = i * 0.25f - 7;
+        y[i] = 3 - i * 0.5f;
+    }
+    // Unit steps take the unrolled path, other steps the generic loop
+    TEST_ESP_OK(dsps_add_f32_rv32(x, y, z, n, 1, 1, 1));
+    TEST_ESP_OK(dsps_add_f32_ansi(x, y, z_ansi, n, 1, 1, 1));
+    TEST_ASSERT_EQUAL(0, memcmp(z, z_ansi, sizeof(z)));
+    TEST_ESP_OK(dsps_add_f32_rv32(x, y, z, n / 3, 3, 2, 1));
+    TEST_ESP_OK(dsps_add_f32_ansi(x, y, z_ansi, n / 3, 3, 2, 1));
+    TEST_ASSERT_EQUAL(0, memcmp(z, z_ansi, sizeof(z)));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_add_f32_rv32(NULL, y, z, n, 1, 1, 1));
+}
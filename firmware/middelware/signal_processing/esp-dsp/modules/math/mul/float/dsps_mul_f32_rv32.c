@@ -0,0 +1,53 @@
+/**
+ * @file dsps_mul_f32_rv32.c
+ * @brief Unrolled C float vector multiply for the RISC-V cores
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dsps_mul.h"
+
+esp_err_t dsps_mul_f32_rv32(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out)
+{
+    if (NULL == input1) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == input2) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == output) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    if ((step1 == 1) && (step2 == 1) && (step_out == 1)) {
+        const float *end4 = input1 + (len & ~3);
+        const float *end = input1 + len;
+        while (input1 < end4) {
+            float x0 = input1[0] * input2[0];
+            float x1 = input1[1] * input2[1];
+            float x2 = input1[2] * input2[2];
+            float x3 = input1[3] * input2[3];
+            output[0] = x0;
+            output[1] = x1;
+            output[2] = x2;
+            output[3] = x3;
+            input1 += 4;
+            input2 += 4;
+            output += 4;
+        }
+        while (input1 < end) {
+            *output++ = *input1++ * *input2++;
+        }
+        return ESP_OK;
+    }
+    for (int i = 0 ; i < len ; i++) {
+        *output = *input1 * *input2;
+        input1 += step1;
+        input2 += step2;
+        output += step_out;
+    }
+    return ESP_OK;
+}
@@ -412,14 +412,16 @@ public:
      * @brief   Solve the matrix
      *
      * Solve matrix. Find roots for the matrix A*x = b
+     * (LU decomposition with partial pivoting)
      *
      * @param[in] A: matrix [N]x[N] with input coefficients
-     * @param[in] b: vector [N]x[1] with result values
+     * @param[in] b: matrix [N]x[K] with result values (K right-hand sides)
      *
      * @return
-     *      - matrix [N]x[1] with roots
+     *      - matrix [N]x[K] with roots
+     *      - matrix [0]x[0] if A is singular
      */
-    static Mat solve(Mat A, Mat b);
+    static Mat solve(const Mat &A, const Mat &b);
     /**
      * @brief   Band solve the matrix
      *
@@ -444,7 +446,7 @@ public:
      * @return
      *      - matrix [N]x[1] with roots
      */
-    static Mat roots(Mat A, Mat y);
+    static Mat roots(const Mat &A, const Mat &y);
 
     /**
      * @brief   Dotproduct of two vectors
@@ -457,7 +459,7 @@ public:
      * @return
      *      - dotproduct value
      */
-    static float dotProduct(Mat A, Mat B);
+    static float dotProduct(const Mat &A, const Mat &B);
 
     /**
      * @brief   Augmented matrices
@@ -470,7 +472,71 @@ public:
      * @return
      *      - Augmented matrix Mx(N+K)
      */
-    static Mat augment(Mat A, Mat B);
+    static Mat augment(const Mat &A, const Mat &B);
+
+    /**
+     * @brief   Fused multiply-add into a preallocated matrix
+     *
+     * D = alpha*A*B + beta*C, evaluated in one pass without temporary matrices.
+     * D may be the same matrix as C, but not A or B.
+     *
+     * @param[in] A: Input matrix MxN
+     * @param[in] B: Input matrix NxK
+     * @param[in] C: Input matrix MxK
+     * @param[out] D: Result matrix MxK
+     * @param[in] alpha: scale of A*B
+     * @param[in] beta: scale of C
+     */
+    static void mult_add(const Mat &A, const Mat &B, const Mat &C, Mat &D, float alpha = 1, float beta = 1);
+
+    /**
+     * @brief   Multiply by a transposed matrix into a preallocated matrix
+     *
+     * C = alpha*A*B', without the copy made by B.t(): every element is the dot product
+     * of a row of A and a row of B. C must not be A or B.
+     *
+     * @param[in] A: Input matrix MxN
+     * @param[in] B: Input matrix KxN
+     * @param[out] C: Result matrix MxK
+     * @param[in] alpha: scale of the product
+     */
+    static void mult_transB(const Mat &A, const Mat &B, Mat &C, float alpha = 1);
+
+    /**
+     * @brief   Quadratic form into a preallocated matrix
+     *
+     * C = alpha*A*B*A' + beta*C (for example covariance propagation F*P*F'),
+     * computed one row of A*B at a time. Zero elements of A are skipped.
+     * C must not be A or B. With beta = 0 the previous content of C is not read.
+     *
+     * @param[in] A: Input matrix MxN
+     * @param[in] B: Input matrix NxN
+     * @param[in,out] C: Result matrix MxM
+     * @param[in] alpha: scale of A*B*A'
+     * @param[in] beta: scale of the previous content of C
+     * @param[in] work: work buffer of N floats (allocated by the method if NULL)
+     */
+    static void quadratic_form(const Mat &A, const Mat &B, Mat &C, float alpha = 1, float beta = 0, float *work = NULL);
+
+    /**
+     * @brief   Symmetric quadratic form into a preallocated matrix
+     *
+     * Same as quadratic_form() for a symmetric B (covariance propagation): only the upper
+     * triangle of C is computed and mirrored to the lower one, and every multiplication by
+     * a zero element of A or B is skipped, so sparse A (for example a linearized transition
+     * matrix I + F*dt) costs much less than a dense product.
+     *
+     * @param[in] A: Input matrix MxN
+     * @param[in] B: Input symmetric matrix NxN
+     * @param[in,out] C: Result symmetric matrix MxM
+     * @param[in] alpha: scale of A*B*A'
+     * @param[in] beta: scale of the previous content of C (symmetric)
+     * @param[in] work: work buffer of N floats (allocated by the method if NULL)
+     *
+     * @return
+     *      - number of multiply-accumulate operations done (for benchmarks)
+     */
+    static int quadratic_form_sym(const Mat &A, const Mat &B, Mat &C, float alpha = 1, float beta = 0, float *work = NULL);
     /**
      * @brief   Gaussian Elimination
      *
@@ -491,33 +557,95 @@ public:
 
     /**
      * Find the inverse matrix
+     * Closed form up to 3x3, LU decomposition with partial pivoting above.
      *
      * @return
      *      - inverse matrix
+     *      - matrix filled with 0 if the matrix is singular
      */
     Mat inverse();
 
     /**
      * Find pseudo inverse matrix
+     * Square matrix: inverse(). MxN matrix: least-squares pseudo inverse
+     * inv(A'*A)*A' (M > N) or A'*inv(A*A') (M < N), solved by Cholesky decomposition.
      *
      * @return
-     *      - inverse matrix
+     *      - inverse matrix NxM
      */
     Mat pinv();
 
     /**
-     * Find determinant
-     * @param[in] n: element number in first row
+     * @brief   LU decomposition with partial pivoting (in place)
+     *
+     * The matrix is replaced by L (below the diagonal, unit diagonal not stored) and U.
+     *
+     * @param[out] perm: row interchanges (N values): row k was swapped with row perm[k].
+     *                   Needed by luSolve(), can be NULL.
+     * @param[in,out] b: matrix whose rows are swapped together with the rows of this matrix
+     *                   (to solve right away with solveLower() and solveUpper()), can be NULL
+     *
+     * @return
+     *      - true on success
+     *      - false if the matrix is singular or not square
+     */
+    bool luDecompose(int *perm, Mat *b = NULL);
+
+    /**
+     * Solve A*x = b with the result of luDecompose() (in place: b is replaced by x)
+     * @param[in] perm: row interchanges returned by luDecompose()
+     * @param[in,out] b: matrix [N]x[K]
+     */
+    void luSolve(const int *perm, Mat &b) const;
+
+    /**
+     * @brief   Cholesky decomposition A = L*L' (in place)
+     *
+     * For symmetric positive-definite matrices (covariances). The matrix is replaced by L,
+     * the upper triangle is set to 0. Half the cost of luDecompose().
+     *
+     * @return
+     *      - true on success
+     *      - false if the matrix is not positive-definite or not square
+     */
+    bool cholesky();
+
+    /**
+     * Solve A*x = b with the result of cholesky() (in place: b is replaced by x)
+     * @param[in,out] b: matrix [N]x[K]
+     */
+    void choleskySolve(Mat &b) const;
+
+    /**
+     * Solve L*x = b, L is the lower triangle of this matrix (in place: b is replaced by x)
+     * @param[in,out] b: matrix [N]x[K]
+     * @param[in] unit_diag: the diagonal of L is 1 (not read)
+     */
+    void solveLower(Mat &b, bool unit_diag = false) const;
+
+    /**
+     * Solve L'*x = b, L is the lower triangle of this matrix (in place: b is replaced by x)
+     * @param[in,out] b: matrix [N]x[K]
+     */
+    void solveLowerTrans(Mat &b) const;
+
+    /**
+     * Solve U*x = b, U is the upper triangle of this matrix (in place: b is replaced by x)
+     * @param[in,out] b: matrix [N]x[K]
+     */
+    void solveUpper(Mat &b) const;
+
+    /**
+     * Find determinant (LU decomposition with partial pivoting)
+     * @param[in] n: size of the leading n x n block (matrix rows for the whole matrix)
      *
      * @return
-     *      - determinant value
+     *      - determinant value (0 if the matrix is singular)
      */
     float det(int n);
 private:
-    Mat cofactor(int row, int col, int n);
-    Mat adjoint();
 
-    void allocate(); // Allocate buffer
+    void allocate(bool use_arena = true); // Allocate buffer (use_arena = false: heap only)
     Mat expHelper(const Mat &m, int num);
 };
 /**
@@ -0,0 +1,122 @@
+/**
+ * @file mat_arena.h
+ * @brief Scratch arena for the temporary matrices
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _dspm_mat_arena_h_
+#define _dspm_mat_arena_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace dspm {
+/**
+ * @brief   Bump allocator for Mat buffers
+ *
+ * While a MatArenaScope is active in the calling task, every Mat allocated by that task
+ * takes its buffer from the arena instead of the heap: an allocation is a pointer increment
+ * and the release of all the buffers is done at once when the scope ends. A filter step
+ * wrapped in a scope has no heap traffic (deterministic timing, no fragmentation).
+ *
+ * @note Matrices created inside a scope must not be used after the scope ends. Matrices
+ *       resized by operator= always take the new buffer from the heap, so a Mat created
+ *       before the scope (a filter member for example) stays valid after it.
+ *       When the arena is full the Mat falls back to the heap and overflows() is incremented.
+ */
+class MatArena {
+public:
+    /**
+     * Constructor: allocate the arena buffer from the heap (once)
+     * @param[in] size: arena size in bytes
+     */
+    MatArena(size_t size);
+
+    /**
+     * Constructor: use an external buffer
+     * @param[in] buffer: arena buffer
+     * @param[in] size: buffer size in bytes
+     */
+    MatArena(void *buffer, size_t size);
+
+    ~MatArena();
+
+    /**
+     * Allocate a float buffer
+     * @param[in] count: number of floats
+     *
+     * @return
+     *      - pointer to the buffer (16 bytes aligned)
+     *      - NULL if the arena is full
+     */
+    float *alloc(int count);
+
+    /**
+     * Release all the buffers
+     */
+    void reset();
+
+    size_t size() const
+    {
+        return capacity;    /*!< Arena size in bytes*/
+    }
+    size_t used() const
+    {
+        return offset;      /*!< Bytes currently allocated*/
+    }
+    size_t peak() const
+    {
+        return peak_used;   /*!< Maximum bytes allocated since construction*/
+    }
+    uint32_t overflows() const
+    {
+        return overflow_count;  /*!< Allocations that did not fit and went to the heap*/
+    }
+
+    /**
+     * Arena active in the calling task (NULL if none)
+     */
+    static MatArena *active();
+
+private:
+    friend class MatArenaScope;
+    MatArena(const MatArena &);
+    MatArena &operator=(const MatArena &);
+
+    uint8_t *raw;
+    uint8_t *buffer;
+    size_t capacity;
+    size_t offset;
+    size_t peak_used;
+    uint32_t overflow_count;
+    static thread_local MatArena *current;
+};
+
+/**
+ * @brief   Scope of a MatArena
+ *
+ * Activates the arena for the calling task. The destructor releases everything allocated
+ * in the scope and restores the previously active arena, so scopes can be nested.
+ */
+class MatArenaScope {
+public:
+    /**
+     * @param[in] arena: arena to activate (NULL: heap allocations)
+     */
+    explicit MatArenaScope(MatArena *arena);
+    ~MatArenaScope();
+
+private:
+    MatArenaScope(const MatArenaScope &);
+    MatArenaScope &operator=(const MatArenaScope &);
+
+    MatArena *arena;
+    MatArena *previous;
+    size_t mark;
+};
+}
+#endif //_dspm_mat_arena_h_
@@ -0,0 +1,195 @@
+/**
+ * @file matn.h
+ * @brief Matrices with compile-time dimensions and inline storage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _dspm_matn_h_
+#define _dspm_matn_h_
+
+#include <string.h>
+#include "mat.h"
+#include "esp_log.h"
+#include "dsps_math.h"
+#include "dspm_matrix.h"
+
+namespace dspm {
+/**
+ * @brief   Matrix with compile-time dimensions and inline storage
+ *
+ * MatN<R, C> is a Mat whose data buffer is a member array: creating, copying and
+ * returning it never touches the heap. It can be passed to every function that takes
+ * a Mat, and the operators between MatN objects return MatN objects computed with the
+ * same dsps/dspm kernels used by Mat.
+ *
+ * @note Assigning a Mat with different dimensions is rejected (the storage can't be resized).
+ */
+template <int R, int C>
+class MatN : public Mat {
+public:
+    float buf[R * C];   /*!< Inline storage of the matrix data*/
+
+    /**
+     * Constructor: matrix filled with zeros
+     */
+    MatN() : Mat(buf, R, C)
+    {
+        memset(buf, 0, sizeof(buf));
+    }
+
+    /**
+     * Constructor: copy of external data (row-major, R*C values)
+     * @param[in] src: data to copy
+     */
+    explicit MatN(const float *src) : Mat(buf, R, C)
+    {
+        memcpy(buf, src, sizeof(buf));
+    }
+
+    /**
+     * Copy constructor
+     */
+    MatN(const MatN &src) : Mat(buf, R, C)
+    {
+        memcpy(buf, src.buf, sizeof(buf));
+    }
+
+    /**
+     * Constructor: copy of a Mat (or sub-matrix) with the same dimensions
+     */
+    explicit MatN(const Mat &src) : Mat(buf, R, C)
+    {
+        memset(buf, 0, sizeof(buf));
+        *this = src;
+    }
+
+    MatN &operator=(const MatN &src)
+    {
+        if (this != &src) {
+            memcpy(buf, src.buf, sizeof(buf));
+        }
+        return *this;
+    }
+
+    MatN &operator=(const Mat &src)
+    {
+        if (src.rows != R || src.cols != C) {
+            ESP_LOGE("MatN", "operator = Error: operand dimensions %dx%d, expected %dx%d", src.rows, src.cols, R, C);
+            return *this;
+        }
+        for (int row = 0; row < R; row++) {
+            memcpy(&buf[row * C], src.data + row * src.stride, C * sizeof(float));
+        }
+        return *this;
+    }
+
+    MatN &operator+=(const MatN &A)
+    {
+        dsps_add_f32(buf, A.buf, buf, R * C, 1, 1, 1);
+        return *this;
+    }
+
+    MatN &operator-=(const MatN &A)
+    {
+        dsps_sub_f32(buf, A.buf, buf, R * C, 1, 1, 1);
+        return *this;
+    }
+
+    MatN &operator*=(float C_)
+    {
+        dsps_mulc_f32(buf, buf, R * C, C_, 1, 1);
+        return *this;
+    }
+
+    /**
+     * Transpose
+     * @return transposed matrix
+     */
+    MatN<C, R> t() const
+    {
+        MatN<C, R> ret;
+        for (int i = 0; i < R; i++) {
+            for (int j = 0; j < C; j++) {
+                ret.buf[j * R + i] = buf[i * C + j];
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * Store the transpose of a C x R matrix (no temporary matrix)
+     * @param[in] src: matrix to transpose
+     * @return reference to this matrix
+     */
+    MatN &transposeOf(const Mat &src)
+    {
+        if (src.rows != C || src.cols != R) {
+            ESP_LOGE("MatN", "transposeOf Error: operand dimensions %dx%d, expected %dx%d", src.rows, src.cols, C, R);
+            return *this;
+        }
+        for (int i = 0; i < C; i++) {
+            for (int j = 0; j < R; j++) {
+                buf[j * C + i] = src.data[i * src.stride + j];
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * Identity matrix (square matrices only)
+     */
+    static MatN eye()
+    {
+        static_assert(R == C, "eye() needs a square matrix");
+        MatN ret;
+        for (int i = 0; i < R; i++) {
+            ret.buf[i * C + i] = 1;
+        }
+        return ret;
+    }
+};
+
+template <int R, int K, int C>
+MatN<R, C> operator*(const MatN<R, K> &A, const MatN<K, C> &B)
+{
+    MatN<R, C> ret;
+    dspm_mult_f32(A.buf, B.buf, ret.buf, R, K, C);
+    return ret;
+}
+
+template <int R, int C>
+MatN<R, C> operator+(const MatN<R, C> &A, const MatN<R, C> &B)
+{
+    MatN<R, C> ret;
+    dsps_add_f32(A.buf, B.buf, ret.buf, R * C, 1, 1, 1);
+    return ret;
+}
+
+template <int R, int C>
+MatN<R, C> operator-(const MatN<R, C> &A, const MatN<R, C> &B)
+{
+    MatN<R, C> ret;
+    dsps_sub_f32(A.buf, B.buf, ret.buf, R * C, 1, 1, 1);
+    return ret;
+}
+
+template <int R, int C>
+MatN<R, C> operator*(const MatN<R, C> &A, float C_)
+{
+    MatN<R, C> ret;
+    dsps_mulc_f32(A.buf, ret.buf, R * C, C_, 1, 1);
+    return ret;
+}
+
+template <int R, int C>
+MatN<R, C> operator*(float C_, const MatN<R, C> &A)
+{
+    return A * C_;
+}
+
+}
+#endif //_dspm_matn_h_
@@ -15,9 +15,11 @@
 #include <stdexcept>
 #include <string.h>
 #include "mat.h"
+#include "mat_arena.h"
 #include "esp_log.h"
 
 #include "dsps_math.h"
+#include "dsps_dotprod.h"
 #include "dspm_matrix.h"
 #include <math.h>
 #include <cmath>
@@ -33,6 +35,14 @@ namespace dspm {
 
 float Mat::abs_tol = 1e-10;
 
+// Zero test on the bit pattern (+0 or -0): no float compare on targets without FPU
+static inline bool mat_is_zero(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits << 1) == 0;
+}
+
 Mat::Rect::Rect(int x, int y, int width, int height)
 {
     this->x = x;
@@ -248,7 +258,8 @@ Mat &Mat::operator=(const Mat &m)
         this->stride = this->cols;
         this->padding = 0;
         this->sub_matrix = false;
-        allocate();
+        // A resized Mat may outlive the active MatArenaScope: heap only
+        allocate(false);
     }
 
     for (int row = 0; row < this->rows; row++) {
@@ -463,49 +474,19 @@ float Mat::norm(void)
     return sqr_norm;
 }
 
-Mat Mat::solve(Mat A, Mat b)
+Mat Mat::solve(const Mat &A, const Mat &b)
 {
-    // Gaussian elimination
-    for (int i = 0; i < A.rows; ++i) {
-        if (A(i, i) == 0) {
-            // pivot 0 - error
-            ESP_LOGW("Mat", "Error: the coefficient matrix has 0 as a pivot. Please fix the input and try again.");
-            Mat err_result(0, 0);
-            return err_result;
-        }
-        float a_ii = 1 / A(i, i);
-        for (int j = i + 1; j < A.rows; ++j) {
-            float a_ji = A(j, i) * a_ii;
-            for (int k = i + 1; k < A.cols; ++k) {
-                A(j, k) -= A(i, k) * a_ji;
-                if ((A(j, k) < abs_tol) && (A(j, k) > -1 * abs_tol)) {
-                    A(j, k) = 0;
-                }
-            }
-            b(j, 0) -= b(i, 0) * a_ji;
-            if (A(j, 0) < abs_tol && A(j, 0) > -1 * abs_tol) {
-                A(j, 0) = 0;
-            }
-            A(j, i) = 0;
-        }
-    }
-
-    // Back substitution
-    Mat x(b.rows, 1);
-    x((x.rows - 1), 0) = b((x.rows - 1), 0) / A((x.rows - 1), (x.rows - 1));
-    if (x((x.rows - 1), 0) < abs_tol && x((x.rows - 1), 0) > -1 * abs_tol) {
-        x((x.rows - 1), 0) = 0;
-    }
-    for (int i = x.rows - 2; i >= 0; --i) {
-        float sum = 0;
-        for (int j = i + 1; j < x.rows; ++j) {
-            sum += A(i, j) * x(j, 0);
-        }
-        x(i, 0) = (b(i, 0) - sum) / A(i, i);
-        if (x(i, 0) < abs_tol && x(i, 0) > -1 * abs_tol) {
-            x(i, 0) = 0;
-        }
-    }
+    Mat LU(A.rows, A.cols);
+    Mat x(b.rows, b.cols);
+    LU = A;
+    x = b;
+    if ((A.rows != b.rows) || !LU.luDecompose(NULL, &x)) {
+        ESP_LOGW("Mat", "Error: the coefficient matrix is singular. Please fix the input and try again.");
+        Mat err_result(0, 0);
+        return err_result;
+    }
+    LU.solveLower(x, true);
+    LU.solveUpper(x);
     return x;
 }
 
@@ -547,7 +528,7 @@ Mat Mat::bandSolve(Mat A, Mat b, int k)
     return x;
 }
 
-Mat Mat::roots(Mat A, Mat y)
+Mat Mat::roots(const Mat &A, const Mat &y)
 {
     int n = A.cols + 1;
 
@@ -571,7 +552,7 @@ Mat Mat::roots(Mat A, Mat y)
     return result;
 }
 
-float Mat::dotProduct(Mat a, Mat b)
+float Mat::dotProduct(const Mat &a, const Mat &b)
 {
     float sum = 0;
     for (int i = 0; i < a.rows; ++i) {
@@ -580,7 +561,7 @@ float Mat::dotProduct(Mat a, Mat b)
     return sum;
 }
 
-Mat Mat::augment(Mat A, Mat B)
+Mat Mat::augment(const Mat &A, const Mat &B)
 {
     Mat AB(A.rows, A.cols + B.cols);
     for (int i = 0; i < AB.rows; ++i) {
@@ -595,6 +576,126 @@ Mat Mat::augment(Mat A, Mat B)
     return AB;
 }
 
+void Mat::mult_add(const Mat &A, const Mat &B, const Mat &C, Mat &D, float alpha, float beta)
+{
+    if ((A.cols != B.rows) || (C.rows != A.rows) || (C.cols != B.cols) || (D.rows != A.rows) || (D.cols != B.cols)) {
+        ESP_LOGW("Mat", "mult_add Error: matrices do not have correct dimensions");
+        return;
+    }
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = 0; j < B.cols; j++) {
+            float acc = 0;
+            for (int k = 0; k < A.cols; k++) {
+                acc += A(i, k) * B(k, j);
+            }
+            D(i, j) = alpha * acc + beta * C(i, j);
+        }
+    }
+}
+
+void Mat::mult_transB(const Mat &A, const Mat &B, Mat &C, float alpha)
+{
+    if ((A.cols != B.cols) || (C.rows != A.rows) || (C.cols != B.rows)) {
+        ESP_LOGW("Mat", "mult_transB Error: matrices do not have correct dimensions");
+        return;
+    }
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = 0; j < B.rows; j++) {
+            dsps_dotprod_f32(&A.data[i * A.stride], &B.data[j * B.stride], &C(i, j), A.cols);
+            C(i, j) *= alpha;
+        }
+    }
+}
+
+void Mat::quadratic_form(const Mat &A, const Mat &B, Mat &C, float alpha, float beta, float *work)
+{
+    if ((A.cols != B.rows) || (B.rows != B.cols) || (C.rows != A.rows) || (C.cols != A.rows)) {
+        ESP_LOGW("Mat", "quadratic_form Error: matrices do not have correct dimensions");
+        return;
+    }
+    float *row = work;
+    if (row == NULL) {
+        row = new float[B.cols];
+    }
+    for (int i = 0; i < A.rows; i++) {
+        // row = A(i,:)*B
+        memset(row, 0, B.cols * sizeof(float));
+        for (int k = 0; k < A.cols; k++) {
+            float a = A(i, k);
+            if (mat_is_zero(a)) {
+                continue;
+            }
+            for (int j = 0; j < B.cols; j++) {
+                row[j] += a * B(k, j);
+            }
+        }
+        // C(i,:) = alpha*row*A' + beta*C(i,:)
+        for (int j = 0; j < A.rows; j++) {
+            float acc;
+            dsps_dotprod_f32(row, &A.data[j * A.stride], &acc, A.cols);
+            if (beta == 0) {
+                C(i, j) = alpha * acc;
+            } else {
+                C(i, j) = alpha * acc + beta * C(i, j);
+            }
+        }
+    }
+    if (work == NULL) {
+        delete[] row;
+    }
+}
+
+int Mat::quadratic_form_sym(const Mat &A, const Mat &B, Mat &C, float alpha, float beta, float *work)
+{
+    if ((A.cols != B.rows) || (B.rows != B.cols) || (C.rows != A.rows) || (C.cols != A.rows)) {
+        ESP_LOGW("Mat", "quadratic_form_sym Error: matrices do not have correct dimensions");
+        return 0;
+    }
+    int macs = 0;
+    float *row = work;
+    if (row == NULL) {
+        row = new float[B.cols];
+    }
+    for (int i = 0; i < A.rows; i++) {
+        // row = A(i,:)*B, zero elements of A and B skipped
+        memset(row, 0, B.cols * sizeof(float));
+        for (int k = 0; k < A.cols; k++) {
+            float a = A(i, k);
+            if (mat_is_zero(a)) {
+                continue;
+            }
+            const float *b_row = &B.data[k * B.stride];
+            for (int j = 0; j < B.cols; j++) {
+                if (!mat_is_zero(b_row[j])) {
+                    row[j] += a * b_row[j];
+                    macs++;
+                }
+            }
+        }
+        // Upper triangle: C(i,j) = alpha*row*A(j,:)' + beta*C(i,j), j >= i
+        for (int j = i; j < A.rows; j++) {
+            const float *a_row = &A.data[j * A.stride];
+            float acc = 0;
+            for (int k = 0; k < A.cols; k++) {
+                if (!mat_is_zero(a_row[k]) && !mat_is_zero(row[k])) {
+                    acc += row[k] * a_row[k];
+                    macs++;
+                }
+            }
+            if (beta == 0) {
+                C(i, j) = alpha * acc;
+            } else {
+                C(i, j) = alpha * acc + beta * C(i, j);
+            }
+            C(j, i) = C(i, j);
+        }
+    }
+    if (work == NULL) {
+        delete[] row;
+    }
+    return macs;
+}
+
 Mat Mat::gaussianEliminate()
 {
     Mat Ab(*this);
@@ -704,125 +805,260 @@ Mat Mat::rowReduceFromGaussian()
 
 Mat Mat::pinv()
 {
-    Mat I = Mat::eye(this->rows);
-    Mat AI = Mat::augment(*this, I);
-    Mat U = AI.gaussianEliminate();
-    Mat IAInverse = U.rowReduceFromGaussian();
-    Mat AInverse(this->rows, this->cols);
-    for (int i = 0; i < this->rows; ++i) {
-        for (int j = 0; j < this->cols; ++j) {
-            AInverse(i, j) = IAInverse(i, j + this->cols);
-        }
+    if (this->rows == this->cols) {
+        return this->inverse();
+    }
+    bool tall = this->rows > this->cols;
+    int n = tall ? this->cols : this->rows;
+    Mat N(n, n);
+    Mat At = this->t();
+    if (tall) {
+        Mat::mult_transB(At, At, N);        // A'*A
+    } else {
+        Mat::mult_transB(*this, *this, N);  // A*A'
+    }
+    if (!N.cholesky()) {
+        ESP_LOGW("Mat", "pinv Error: matrix is rank deficient");
+        Mat err_ret(this->cols, this->rows);
+        return err_ret;
     }
-    return AInverse;
+    if (tall) {
+        // inv(A'*A)*A'
+        N.choleskySolve(At);
+        return At;
+    }
+    // A'*inv(A*A') = (inv(A*A')*A)'
+    Mat X(this->rows, this->cols);
+    X = *this;
+    N.choleskySolve(X);
+    return X.t();
 }
 
-Mat Mat::cofactor(int row, int col, int n)
+bool Mat::luDecompose(int *perm, Mat *b)
 {
-    int i = 0, j = 0;
-    Mat result(n, n);
-    // Looping for each element of the matrix
-    for (int r = 0; r < n; r++) {
-        for (int c = 0; c < n; c++) {
-            //  Copying into temporary matrix only those element
-            //  which are not in given row and column
-            if (r != row && c != col) {
-                result(i, j++) = (*this)(r, c);
-
-                // Row is filled, so increase row index and
-                // reset col index
-                if (j == this->rows - 1) {
-                    j = 0;
-                    i++;
-                }
+    if (this->rows != this->cols) {
+        ESP_LOGW("Mat", "luDecompose Error: matrix is not square");
+        return false;
+    }
+    int n = this->rows;
+    for (int k = 0; k < n; k++) {
+        // Partial pivoting: largest element of the column
+        int p = k;
+        float max = fabsf((*this)(k, k));
+        for (int i = k + 1; i < n; i++) {
+            if (fabsf((*this)(i, k)) > max) {
+                max = fabsf((*this)(i, k));
+                p = i;
+            }
+        }
+        if (max <= abs_tol) {
+            return false;
+        }
+        if (perm != NULL) {
+            perm[k] = p;
+        }
+        if (p != k) {
+            this->swapRows(p, k);
+            if (b != NULL) {
+                b->swapRows(p, k);
+            }
+        }
+        float *row_k = &this->data[k * this->stride];
+        float inv_pivot = 1 / row_k[k];
+        for (int i = k + 1; i < n; i++) {
+            float *row_i = &this->data[i * this->stride];
+            float l = row_i[k] * inv_pivot;
+            row_i[k] = l;
+            if (l == 0) {
+                continue;
+            }
+            for (int j = k + 1; j < n; j++) {
+                row_i[j] -= l * row_k[j];
             }
         }
     }
-    return result;
+    return true;
 }
 
-float Mat::det(int n)
+void Mat::luSolve(const int *perm, Mat &b) const
 {
-    float D = 0; // Initialize result
-
-    //  Base case : if matrix contains single element
-    if (n == 1) {
-        return (*this)(0, 0);
+    for (int k = 0; k < this->rows; k++) {
+        if (perm[k] != k) {
+            b.swapRows(perm[k], k);
+        }
     }
+    this->solveLower(b, true);
+    this->solveUpper(b);
+}
 
-    Mat temp(this->rows, this->rows); // To store cofactors
-
-    int sign = 1;  // To store sign multiplier
-
-    // Iterate for each element of first row
-    for (int f = 0; f < n; f++) {
-        // Getting Cofactor of A[0][f]
-        Mat temp = this->cofactor(0, f, n);
-        D += (*this)(0, f) * temp.det(n - 1) * sign;
-
-        // terms are to be added with alternate sign
-        sign = -sign;
+bool Mat::cholesky()
+{
+    if (this->rows != this->cols) {
+        ESP_LOGW("Mat", "cholesky Error: matrix is not square");
+        return false;
     }
+    int n = this->rows;
+    for (int j = 0; j < n; j++) {
+        float *row_j = &this->data[j * this->stride];
+        float d = row_j[j];
+        for (int k = 0; k < j; k++) {
+            d -= row_j[k] * row_j[k];
+        }
+        if (d <= 0) {
+            return false;
+        }
+        d = sqrtf(d);
+        row_j[j] = d;
+        float inv_d = 1 / d;
+        for (int i = j + 1; i < n; i++) {
+            float *row_i = &this->data[i * this->stride];
+            float sum = row_i[j];
+            for (int k = 0; k < j; k++) {
+                sum -= row_i[k] * row_j[k];
+            }
+            row_i[j] = sum * inv_d;
+            row_j[i] = 0;
+        }
+    }
+    return true;
+}
 
-    return D;
+void Mat::choleskySolve(Mat &b) const
+{
+    this->solveLower(b);
+    this->solveLowerTrans(b);
 }
 
-Mat Mat::adjoint()
+void Mat::solveLower(Mat &b, bool unit_diag) const
 {
-    Mat adj(this->rows, this->cols);
-    if (this->rows == 1) {
-        adj(0, 0) = 1;
-        return adj;
+    for (int c = 0; c < b.cols; c++) {
+        for (int i = 0; i < this->rows; i++) {
+            const float *row_i = &this->data[i * this->stride];
+            float sum = b(i, c);
+            for (int k = 0; k < i; k++) {
+                sum -= row_i[k] * b(k, c);
+            }
+            b(i, c) = unit_diag ? sum : sum / row_i[i];
+        }
     }
+}
 
-    // temp is used to store cofactors of A(,)
-    int sign = 1;
-    Mat temp(this->rows, this->cols);
-
-    for (int i = 0; i < this->rows; i++) {
-        for (int j = 0; j < this->cols; j++) {
-            // Get cofactor of A(i,j)
-            temp = this->cofactor( i, j, this->rows);
+void Mat::solveLowerTrans(Mat &b) const
+{
+    for (int c = 0; c < b.cols; c++) {
+        for (int i = this->rows - 1; i >= 0; i--) {
+            float sum = b(i, c);
+            for (int k = i + 1; k < this->rows; k++) {
+                sum -= (*this)(k, i) * b(k, c);
+            }
+            b(i, c) = sum / (*this)(i, i);
+        }
+    }
+}
 
-            // sign of adj(j,i) positive if sum of row
-            // and column indexes is even.
-            sign = ((i + j) % 2 == 0) ? 1 : -1;
+void Mat::solveUpper(Mat &b) const
+{
+    for (int c = 0; c < b.cols; c++) {
+        for (int i = this->rows - 1; i >= 0; i--) {
+            const float *row_i = &this->data[i * this->stride];
+            float sum = b(i, c);
+            for (int k = i + 1; k < this->rows; k++) {
+                sum -= row_i[k] * b(k, c);
+            }
+            b(i, c) = sum / row_i[i];
+        }
+    }
+}
 
-            // Interchanging rows and columns to get the
-            // transpose of the cofactor matrix
-            adj(j, i) = (sign) * (temp.det(this->rows - 1));
+float Mat::det(int n)
+{
+    // LU with partial pivoting: det = sign(P) * prod(diag(U)), O(n^3)
+    Mat LU = this->block(0, 0, n, n);
+    int *perm = new int[n];
+    float D = 0;
+    if (LU.luDecompose(perm, NULL)) {
+        D = 1;
+        for (int k = 0; k < n; k++) {
+            D *= LU(k, k);
+            if (perm[k] != k) {
+                D = -D;
+            }
         }
     }
-    return adj;
+    delete[] perm;
+    return D;
 }
 
 Mat Mat::inverse()
 {
     Mat result(this->rows, this->cols);
-    // Find determinant of matrix
-    float det = this->det(this->rows);
-    if (det == 0) {
-        //std::cout << "Singular matrix, can't find its inverse";
+    const Mat &m = *this;
+    if (this->rows != this->cols) {
+        ESP_LOGW("Mat", "inverse Error: matrix is not square");
         return result;
     }
-
-    // Find adjoint
-    Mat adj = this->adjoint();
-
-    // Find Inverse using formula "inverse(A) = adj(A)/det(A)"
-    for (int i = 0; i < this->rows; i++)
-        for (int j = 0; j < this->cols; j++) {
-            result(i, j) = adj(i, j) / float(det);
+    // Closed form (adjugate / determinant) for the small sizes
+    if (this->rows == 1) {
+        if (m(0, 0) != 0) {
+            result(0, 0) = 1 / m(0, 0);
         }
+        return result;
+    }
+    if (this->rows == 2) {
+        float det = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+        if (det == 0) {
+            return result;
+        }
+        result(0, 0) = m(1, 1) / det;
+        result(0, 1) = -m(0, 1) / det;
+        result(1, 0) = -m(1, 0) / det;
+        result(1, 1) = m(0, 0) / det;
+        return result;
+    }
+    if (this->rows == 3) {
+        result(0, 0) = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+        result(0, 1) = m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2);
+        result(0, 2) = m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1);
+        result(1, 0) = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+        result(1, 1) = m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0);
+        result(1, 2) = m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2);
+        result(2, 0) = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+        result(2, 1) = m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1);
+        result(2, 2) = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+        float det = m(0, 0) * result(0, 0) + m(0, 1) * result(1, 0) + m(0, 2) * result(2, 0);
+        if (det == 0) {
+            result.clear();
+            return result;
+        }
+        result /= det;
+        return result;
+    }
 
+    // LU with partial pivoting, the row swaps are applied to the identity
+    Mat LU(this->rows, this->cols);
+    LU = *this;
+    for (int i = 0; i < this->rows; i++) {
+        result(i, i) = 1;
+    }
+    if (!LU.luDecompose(NULL, &result)) {
+        result.clear();
+        return result;
+    }
+    LU.solveLower(result, true);
+    LU.solveUpper(result);
     return result;
 }
 
-void Mat::allocate()
+void Mat::allocate(bool use_arena)
 {
-    this->ext_buff = false;
     this->length = this->rows * this->cols;
-    data = new float[this->length];
+    // Inside a MatArenaScope the buffer is released with the arena, not by the destructor
+    MatArena *arena = use_arena ? MatArena::active() : NULL;
+    data = (arena != NULL) ? arena->alloc(this->length) : NULL;
+    this->ext_buff = (data != NULL);
+    if (data == NULL) {
+        data = new float[this->length];
+    }
     ESP_LOGD("Mat", "allocate(%i) = %p", this->length, this->data);
 }
 
@@ -0,0 +1,92 @@
+/**
+ * @file mat_arena.cpp
+ * @brief Scratch arena for the temporary matrices
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "mat_arena.h"
+#include "esp_log.h"
+
+#define MAT_ARENA_ALIGN 16
+
+namespace dspm {
+
+thread_local MatArena *MatArena::current = NULL;
+
+MatArena::MatArena(size_t size)
+{
+    this->raw = new uint8_t[size + MAT_ARENA_ALIGN];
+    // Aligned start: the first allocation has no padding
+    this->buffer = this->raw + (MAT_ARENA_ALIGN - ((uintptr_t)this->raw % MAT_ARENA_ALIGN)) % MAT_ARENA_ALIGN;
+    this->capacity = size;
+    this->offset = 0;
+    this->peak_used = 0;
+    this->overflow_count = 0;
+}
+
+MatArena::MatArena(void *buffer, size_t size)
+{
+    this->raw = NULL;
+    this->buffer = (uint8_t *)buffer;
+    this->capacity = size;
+    this->offset = 0;
+    this->peak_used = 0;
+    this->overflow_count = 0;
+}
+
+MatArena::~MatArena()
+{
+    if (current == this) {
+        current = NULL;
+    }
+    delete[] this->raw;
+}
+
+float *MatArena::alloc(int count)
+{
+    uintptr_t base = (uintptr_t)this->buffer + this->offset;
+    size_t pad = (MAT_ARENA_ALIGN - (base % MAT_ARENA_ALIGN)) % MAT_ARENA_ALIGN;
+    size_t bytes = count * sizeof(float);
+    if ((this->offset + pad + bytes) > this->capacity) {
+        this->overflow_count++;
+        ESP_LOGD("MatArena", "alloc(%i) overflow: %i of %i bytes used", count, (int)this->offset, (int)this->capacity);
+        return NULL;
+    }
+    float *ret = (float *)(base + pad);
+    this->offset += pad + bytes;
+    if (this->offset > this->peak_used) {
+        this->peak_used = this->offset;
+    }
+    return ret;
+}
+
+void MatArena::reset()
+{
+    this->offset = 0;
+}
+
+MatArena *MatArena::active()
+{
+    return current;
+}
+
+MatArenaScope::MatArenaScope(MatArena *arena)
+{
+    this->arena = arena;
+    this->previous = MatArena::current;
+    this->mark = (arena != NULL) ? arena->offset : 0;
+    MatArena::current = arena;
+}
+
+MatArenaScope::~MatArenaScope()
+{
+    if (this->arena != NULL) {
+        this->arena->offset = this->mark;
+    }
+    MatArena::current = this->previous;
+}
+}
@@ -0,0 +1,78 @@
+/**
+ * @file test_mat_arena.cpp
+ * @brief Tests of the matrix scratch arena
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "mat_arena.h"
+
+static const char *TAG = "dspm_MatArena";
+
+TEST_CASE("Mat arena allocations", "[dspm]")
+{
+    dspm::MatArena arena(1024);
+    dspm::Mat A = dspm::Mat::eye(4);
+    TEST_ASSERT_NULL(dspm::MatArena::active());
+    {
+        dspm::MatArenaScope scope(&arena);
+        TEST_ASSERT_EQUAL_PTR(&arena, dspm::MatArena::active());
+        dspm::Mat B(4, 4);
+        B = A;
+        TEST_ASSERT_TRUE(B.ext_buff);
+        TEST_ASSERT_EQUAL(0, ((uintptr_t)B.data) % 16);
+        TEST_ASSERT_EQUAL(16 * sizeof(float), arena.used());
+        {
+            // Nested scope: releases only its own allocations
+            dspm::MatArenaScope inner(&arena);
+            dspm::Mat C(4, 4);
+            dspm::Mat::mult_add(B, A, A, C);
+            TEST_ASSERT_EQUAL_FLOAT(2, C(1, 1));
+        }
+        TEST_ASSERT_EQUAL(16 * sizeof(float), arena.used());
+        // Does not fit: heap fallback
+        dspm::Mat D(16, 16);
+        TEST_ASSERT_FALSE(D.ext_buff);
+        TEST_ASSERT_EQUAL(1, arena.overflows());
+    }
+    TEST_ASSERT_NULL(dspm::MatArena::active());
+    TEST_ASSERT_EQUAL(0, arena.used());
+    TEST_ASSERT_EQUAL(32 * sizeof(float), arena.peak());
+    ESP_LOGI(TAG, "Arena peak %i bytes", (int)arena.peak());
+}
+
+TEST_CASE("Mat arena resize by assignment", "[dspm]")
+{
+    dspm::MatArena arena(1024);
+    dspm::Mat A = dspm::Mat::eye(4);
+    // Created before the scope, like a filter member
+    dspm::Mat P(2, 2);
+    {
+        dspm::MatArenaScope scope(&arena);
+        dspm::Mat B(4, 4);
+        B = A * 2;
+        P = B;
+        TEST_ASSERT_FALSE(P.ext_buff);
+        TEST_ASSERT_EQUAL(4, P.rows);
+    }
+    // The next arena user must not overwrite P
+    {
+        dspm::MatArenaScope scope(&arena);
+        dspm::Mat C(4, 4);
+        C *= 0;
+        C(1, 1) = 7;
+    }
+    TEST_ASSERT_EQUAL_FLOAT(2, P(1, 1));
+    TEST_ASSERT_EQUAL_FLOAT(0, P(1, 0));
+}
@@ -0,0 +1,84 @@
+/**
+ * @file test_mat_fused_f32.cpp
+ * @brief Tests of the fused Mat operations
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+
+static const char *TAG = "dspm_Mat_fused";
+
+static void test_mat_fused_compare(const dspm::Mat &result, const dspm::Mat &expected)
+{
+    TEST_ASSERT_EQUAL(expected.rows, result.rows);
+    TEST_ASSERT_EQUAL(expected.cols, result.cols);
+    for (int i = 0; i < expected.rows; i++) {
+        for (int j = 0; j < expected.cols; j++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4, expected(i, j), result(i, j));
+        }
+    }
+}
+
+TEST_CASE("Mat class fused operations", "[dspm]")
+{
+    dspm::Mat A(5, 4);
+    dspm::Mat B(4, 4);
+    dspm::Mat C(5, 4);
+    dspm::Mat K(3, 4);
+    for (int i = 0; i < A.length; i++) {
+        A.data[i] = sinf(i);
+        C.data[i] = cosf(i);
+    }
+    for (int i = 0; i < B.length; i++) {
+        B.data[i] = 0.3f * i - 1;
+    }
+    for (int i = 0; i < K.length; i++) {
+        K.data[i] = 0.1f * i;
+    }
+    A(2, 1) = 0;
+
+    dspm::Mat D(5, 4);
+    dspm::Mat::mult_add(A, B, C, D, 2, 0.5f);
+    test_mat_fused_compare(D, 2 * (A * B) + 0.5f * C);
+    // in place: C = A*B + C
+    dspm::Mat C_ref = A * B + C;
+    dspm::Mat::mult_add(A, B, C, C);
+    test_mat_fused_compare(C, C_ref);
+
+    dspm::Mat E(5, 3);
+    dspm::Mat::mult_transB(A, K, E);
+    test_mat_fused_compare(E, A * K.t());
+
+    // sub-matrix operands
+    dspm::Mat A_sub = A.getROI(1, 0, 3, 4);
+    dspm::Mat E_sub(3, 3);
+    dspm::Mat::mult_transB(A_sub, K, E_sub);
+    test_mat_fused_compare(E_sub, A.Get(1, 3, 0, 4) * K.t());
+
+    dspm::Mat F(5, 5);
+    dspm::Mat::quadratic_form(A, B, F);
+    test_mat_fused_compare(F, A * B * A.t());
+    float row[4];
+    dspm::Mat::quadratic_form(A, B, F, 0.5f, 1, row);
+    test_mat_fused_compare(F, 1.5f * (A * B * A.t()));
+
+    // Symmetric B: upper triangle computed and mirrored
+    dspm::Mat B_sym = B + B.t();
+    dspm::Mat F_sym(5, 5);
+    int macs = dspm::Mat::quadratic_form_sym(A, B_sym, F_sym);
+    test_mat_fused_compare(F_sym, A * B_sym * A.t());
+    TEST_ASSERT_LESS_THAN(2 * 5 * 4 * 4 + 5 * 5 * 4, macs);
+    ESP_LOGI(TAG, "Fused operations match the operators");
+}
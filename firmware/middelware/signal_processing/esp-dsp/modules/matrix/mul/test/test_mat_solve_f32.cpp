@@ -0,0 +1,123 @@
+/**
+ * @file test_mat_solve_f32.cpp
+ * @brief Tests of the Mat LU and Cholesky solvers
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+
+static const char *TAG = "dspm_Mat_solve";
+
+// Symmetric positive-definite test matrix: M*M' + N*I
+static dspm::Mat test_mat_spd(int n)
+{
+    dspm::Mat M(n, n);
+    dspm::Mat A(n, n);
+    for (int i = 0; i < M.length; i++) {
+        M.data[i] = sinf(i * 0.7f + 0.3f);
+    }
+    dspm::Mat::mult_transB(M, M, A);
+    for (int i = 0; i < n; i++) {
+        A(i, i) += n;
+    }
+    return A;
+}
+
+static void test_mat_check_identity(const dspm::Mat &I, float tol)
+{
+    for (int i = 0; i < I.rows; i++) {
+        for (int j = 0; j < I.cols; j++) {
+            TEST_ASSERT_FLOAT_WITHIN(tol, (i == j) ? 1 : 0, I(i, j));
+        }
+    }
+}
+
+TEST_CASE("Mat class LU and Cholesky", "[dspm]")
+{
+    for (int n = 4; n <= 16; n += 4) {
+        dspm::Mat A = test_mat_spd(n);
+        // Non-symmetric and a zero leading element: needs pivoting
+        dspm::Mat B = A;
+        B(0, 0) = 0;
+        B(0, n - 1) += 1;
+
+        test_mat_check_identity(B * B.inverse(), 1e-4);
+        test_mat_check_identity(A * A.pinv(), 1e-4);
+
+        dspm::Mat x = dspm::Mat::ones(n, 2);
+        x(1, 1) = -3;
+        dspm::Mat b = B * x;
+        dspm::Mat x_lu = dspm::Mat::solve(B, b);
+        int perm[16];
+        dspm::Mat LU = B;
+        TEST_ASSERT_TRUE(LU.luDecompose(perm));
+        dspm::Mat x_perm = b;
+        LU.luSolve(perm, x_perm);
+
+        dspm::Mat L = A;
+        TEST_ASSERT_TRUE(L.cholesky());
+        TEST_ASSERT_EQUAL_FLOAT(0, L(0, n - 1));
+        dspm::Mat b_spd = A * x;
+        L.choleskySolve(b_spd);
+        for (int i = 0; i < x.length; i++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4, x.data[i], x_lu.data[i]);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4, x.data[i], x_perm.data[i]);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4, x.data[i], b_spd.data[i]);
+        }
+        TEST_ASSERT_FALSE(B.cholesky());
+    }
+    // Least-squares pseudo inverse of a tall matrix: pinv(A)*A = I
+    dspm::Mat T(6, 3);
+    for (int i = 0; i < T.length; i++) {
+        T.data[i] = cosf(i * i * 0.37f);
+    }
+    test_mat_check_identity(T.pinv() * T, 1e-4);
+    // Singular matrix
+    dspm::Mat S = dspm::Mat::ones(4);
+    TEST_ASSERT_EQUAL(0, dspm::Mat::solve(S, dspm::Mat::ones(4, 1)).rows);
+}
+
+TEST_CASE("Mat class LU and Cholesky benchmark", "[dspm]")
+{
+    const int repeat_count = 16;
+    for (int n = 4; n <= 16; n += 4) {
+        dspm::Mat A = test_mat_spd(n);
+        dspm::Mat b = dspm::Mat::ones(n, 1);
+        dspm::Mat L(n, n);
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        for (int i = 0; i < repeat_count; i++) {
+            dspm::Mat A_inv = A.inverse();
+        }
+        unsigned int inv_cycles = (dsp_get_cpu_cycle_count() - start_b) / repeat_count;
+
+        start_b = dsp_get_cpu_cycle_count();
+        for (int i = 0; i < repeat_count; i++) {
+            dspm::Mat x = dspm::Mat::solve(A, b);
+        }
+        unsigned int lu_cycles = (dsp_get_cpu_cycle_count() - start_b) / repeat_count;
+
+        start_b = dsp_get_cpu_cycle_count();
+        for (int i = 0; i < repeat_count; i++) {
+            L = A;
+            L.cholesky();
+            dspm::Mat x = b;
+            L.choleskySolve(x);
+        }
+        unsigned int chol_cycles = (dsp_get_cpu_cycle_count() - start_b) / repeat_count;
+
+        ESP_LOGI(TAG, "%2ix%-2i inverse %8u, LU solve %7u, Cholesky solve %7u cycles", n, n, inv_cycles, lu_cycles, chol_cycles);
+    }
+}
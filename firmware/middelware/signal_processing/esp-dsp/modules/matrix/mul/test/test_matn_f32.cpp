@@ -0,0 +1,52 @@
+/**
+ * @file test_matn_f32.cpp
+ * @brief Tests of the MatN operators
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "matn.h"
+
+static const char *TAG = "dspm_MatN";
+
+TEST_CASE("MatN class operators", "[dspm]")
+{
+    dspm::MatN<3, 4> A;
+    dspm::MatN<4, 3> B;
+    for (int i = 0; i < 12; i++) {
+        A.buf[i] = i + 1;
+        B.buf[i] = 0.5f * i - 2;
+    }
+    // Same expression with heap matrices
+    dspm::Mat A_ref = A;
+    dspm::Mat B_ref = B;
+    dspm::Mat C_ref = (A_ref * B_ref) * 2 + dspm::Mat::eye(3) - A_ref * A_ref.t();
+
+    dspm::MatN<3, 3> C = (A * B) * 2 + dspm::MatN<3, 3>::eye() - A * A.t();
+    TEST_ASSERT_EQUAL(3, C.rows);
+    TEST_ASSERT_EQUAL(3, C.cols);
+    TEST_ASSERT_FALSE(C.data != C.buf);
+    for (int i = 0; i < 9; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, C_ref.data[i], C.data[i]);
+    }
+
+    dspm::MatN<4, 3> B_t;
+    B_t.transposeOf(A_ref);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            TEST_ASSERT_EQUAL_FLOAT(A(i, j), B_t(j, i));
+        }
+    }
+    ESP_LOGI(TAG, "MatN operators match Mat");
+}
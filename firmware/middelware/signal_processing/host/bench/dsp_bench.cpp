@@ -0,0 +1,497 @@
+/**
+ * @file dsp_bench.cpp
+ * @brief Host benchmark of the signal_processing middleware and esp-dsp kernels
+ *
+ * Runs FFT, FIR, biquad, dot product, matrix multiply, orientation filter and
+ * QRS detector cases over several sizes and prints, per case, the time per
+ * sample and the heap allocations per call. The results can be written to CSV
+ * and compared against a previous CSV to flag regressions:
+ *
+ *   dsp_bench --csv base.csv                          (reference run)
+ *   dsp_bench --baseline base.csv --tolerance 25      (exit code 1 on regression)
+ *   dsp_bench --dispatch                              (benchmark with dsps_dispatch_init())
+ *   dsp_bench --check                                 (_rv32 kernels against ANSI, exit code 1 on mismatch)
+ *
+ * Host timings only track relative changes: the target is a soft-float
+ * RV32IMAC, so absolute numbers and ANSI/_rv32 ratios differ on the chip.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "esp_dsp.h"
+#include "mat_arena.h"
+#include "ekf_imu13states.h"
+extern "C" {
+#include "fft.h"
+#include "iir_filter.h"
+#include "imu_fusion.h"
+#include "qrs_detector.h"
+}
+#include "dsp_prof.h"
+/*==================[macros and definitions]=================================*/
+#define BENCH_RUNS          5           /*!< Measurements per case, the fastest is reported */
+#define BENCH_RUNS_QUICK    1
+#define BENCH_TIME_NS       20000000    /*!< Minimum duration of one measurement */
+#define BENCH_TIME_NS_QUICK 200000
+#define BENCH_MAX_LEN       4096
+#define BENCH_ARENA_SIZE    6144        /*!< Same as ORIENTATION_ARENA_SIZE */
+
+typedef struct {
+    std::string name;
+    std::string variant;
+    int size;
+    int samples;                        /*!< Samples (or outputs, or updates) processed per call */
+    std::function<void(void)> run;
+} bench_case_t;
+
+typedef struct {
+    double ns_per_sample;
+    double allocs_per_call;
+} bench_result_t;
+/*==================[internal data declaration]==============================*/
+static float x_f32[2 * BENCH_MAX_LEN];
+static float y_f32[2 * BENCH_MAX_LEN];
+static float z_f32[2 * BENCH_MAX_LEN];
+static int16_t x_s16[BENCH_MAX_LEN];
+static int16_t y_s16[BENCH_MAX_LEN];
+static float fir_coeffs[64];
+static float fir_delay[64];
+static float bq_coeffs[5];
+static float bq_w[2];
+static volatile float sink_f32;
+static volatile int16_t sink_s16;
+static unsigned long alloc_count = 0;
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+#if defined(__GLIBC__)
+// Every heap allocation (malloc, calloc, realloc and operator new, which
+// calls malloc) goes through these and is counted.
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size){
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size){
+    alloc_count++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size){
+    alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+#define BENCH_COUNTS_ALLOCS 1
+#else
+#define BENCH_COUNTS_ALLOCS 0
+#endif
+
+static uint64_t BenchNow(void){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bench_result_t BenchRun(const bench_case_t &c, bool quick){
+    bench_result_t result;
+    uint64_t min_time = quick ? BENCH_TIME_NS_QUICK : BENCH_TIME_NS;
+    int runs = quick ? BENCH_RUNS_QUICK : BENCH_RUNS;
+    // Warm up caches and lazily allocated state, then count one call
+    c.run();
+    unsigned long allocs = alloc_count;
+    c.run();
+    result.allocs_per_call = BENCH_COUNTS_ALLOCS ? (double)(alloc_count - allocs) : -1;
+    result.ns_per_sample = INFINITY;
+    for (int r = 0; r < runs; r++) {
+        uint64_t iterations = 0;
+        uint64_t start = BenchNow();
+        uint64_t elapsed = 0;
+        uint64_t batch = 1;
+        while (elapsed < min_time) {
+            for (uint64_t i = 0; i < batch; i++) {
+                c.run();
+            }
+            iterations += batch;
+            batch *= 2;
+            elapsed = BenchNow() - start;
+        }
+        double ns = (double)elapsed / ((double)iterations * c.samples);
+        if (ns < result.ns_per_sample) {
+            result.ns_per_sample = ns;
+        }
+    }
+    return result;
+}
+
+static std::string BenchKey(const std::string &name, const std::string &variant, int size){
+    return name + "," + variant + "," + std::to_string(size);
+}
+
+static std::map<std::string, bench_result_t> BenchLoadCsv(const char *path){
+    std::map<std::string, bench_result_t> table;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot open baseline %s\n", path);
+        exit(2);
+    }
+    char line[256];
+    char name[64], variant[32];
+    int size;
+    bench_result_t r;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%63[^,],%31[^,],%d,%lf,%lf", name, variant, &size, &r.ns_per_sample, &r.allocs_per_call) == 5) {
+            table[BenchKey(name, variant, size)] = r;
+        }
+    }
+    fclose(f);
+    return table;
+}
+
+static void BenchFillInputs(void){
+    for (int i = 0; i < 2 * BENCH_MAX_LEN; i++) {
+        x_f32[i] = sinf(i * 0.05f) + 0.25f * cosf(i * 0.31f);
+        y_f32[i] = cosf(i * 0.02f);
+    }
+    for (int i = 0; i < BENCH_MAX_LEN; i++) {
+        x_s16[i] = (int16_t)(x_f32[i] * 16000);
+        y_s16[i] = (int16_t)(y_f32[i] * 16000);
+    }
+    for (int i = 0; i < 64; i++) {
+        fir_coeffs[i] = sinf(i * 0.1f) / 64;
+    }
+    dsps_biquad_gen_lpf_f32(bq_coeffs, 0.1f, 0.707f);
+}
+
+/**
+ * @brief One orientation update as OrientationStep() runs it, without magnetometer
+ */
+static void BenchEkfStep(ekf_imu13states *filter){
+    float gyro[3] = {0.01f, -0.02f, 0.005f};
+    float accel[3] = {0.02f, -0.01f, 0.98f};
+    float magn[3];
+    float R[6] = {0.1f, 0.1f, 0.1f, 0.01f, 0.01f, 0.01f};
+    float norm = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    for (int i = 0; i < 3; i++) {
+        accel[i] /= norm;
+    }
+    filter->Process(gyro, 0.01f);
+    dspm::Mat Re = ekf::quat2rotm(filter->X.data).t();
+    dspm::Mat magn_state(&filter->X.data[7], 3, 1);
+    dspm::Mat magn_offset(&filter->X.data[10], 3, 1);
+    dspm::Mat expected_magn(magn, 3, 1);
+    dspm::Mat::mult_add(Re, magn_state, magn_offset, expected_magn);
+    filter->UpdateRefMeasurement(accel, magn, R);
+}
+
+static std::vector<bench_case_t> BenchCases(void){
+    std::vector<bench_case_t> cases;
+    static fir_f32_t fir;
+    static ekf_imu13states ekf13;
+    static dspm::MatArena arena(BENCH_ARENA_SIZE);
+    static imu_fusion_t madgwick;
+    static imu_fusion_t mahony;
+    static dspm::Mat A[3], B[3], C[3];
+    static fconv_f32_t fconv[2][3];
+    static qrs_detector_t qrs;
+
+    for (int n : {64, 256, 1024}) {
+        cases.push_back({"dotprod_f32", "ansi", n, n, [n]() {
+            float r;
+            dsps_dotprod_f32_ansi(x_f32, y_f32, &r, n);
+            sink_f32 = r;
+        }});
+        cases.push_back({"dotprod_f32", "rv32", n, n, [n]() {
+            float r;
+            dsps_dotprod_f32_rv32(x_f32, y_f32, &r, n);
+            sink_f32 = r;
+        }});
+        cases.push_back({"dotprod_s16", "ansi", n, n, [n]() {
+            int16_t r;
+            dsps_dotprod_s16_ansi(x_s16, y_s16, &r, n, 0);
+            sink_s16 = r;
+        }});
+        cases.push_back({"dotprod_s16", "rv32", n, n, [n]() {
+            int16_t r;
+            dsps_dotprod_s16_rv32(x_s16, y_s16, &r, n, 0);
+            sink_s16 = r;
+        }});
+    }
+    for (int taps : {16, 64}) {
+        cases.push_back({"fir_f32", "ansi", taps, 256, [taps]() {
+            fir.N = taps;
+            fir.pos %= taps;
+            dsps_fir_f32_ansi(&fir, x_f32, y_f32, 256);
+        }});
+        cases.push_back({"fir_f32", "rv32", taps, 256, [taps]() {
+            fir.N = taps;
+            fir.pos %= taps;
+            dsps_fir_f32_rv32(&fir, x_f32, y_f32, 256);
+        }});
+    }
+    dsps_fir_init_f32(&fir, fir_coeffs, fir_delay, 64);
+    for (int n : {64, 256, 1024}) {
+        cases.push_back({"biquad_f32", "ansi", n, n, [n]() {
+            dsps_biquad_f32_ansi(x_f32, y_f32, n, bq_coeffs, bq_w);
+        }});
+        cases.push_back({"biquad_f32", "rv32", n, n, [n]() {
+            dsps_biquad_f32_rv32(x_f32, y_f32, n, bq_coeffs, bq_w);
+        }});
+        // Middleware: 8th order Butterworth, four cascaded sections
+        cases.push_back({"LowPassFilter", "order8", n, n, [n]() {
+            LowPassFilter(x_f32, y_f32, n);
+        }});
+    }
+    LowPassInit(1000, 40, ORDER_8);
+    // The input is restored before every transform so values do not grow
+    // without bound: the memcpy is part of the measured time.
+    for (int n : {64, 256, 1024, 4096}) {
+        cases.push_back({"fft2r_fc32", "ansi", n, n, [n]() {
+            memcpy(z_f32, x_f32, 2 * n * sizeof(float));
+            dsps_fft2r_fc32_ansi(z_f32, n);
+        }});
+        cases.push_back({"fft2r_fc32", "rv32", n, n, [n]() {
+            memcpy(z_f32, x_f32, 2 * n * sizeof(float));
+            dsps_fft2r_fc32_rv32(z_f32, n);
+        }});
+    }
+    for (int n : {256, 1024, 2048}) {
+        // Middleware: window, FFT, bit reversal and magnitude
+        cases.push_back({"FFTMagnitude", "ansi", n, n, [n]() {
+            FFTMagnitude(x_f32, y_f32, n);
+        }});
+    }
+    // Streaming convolution, 256 sample blocks: size is the kernel length
+    int k = 0;
+    for (int taps : {32, 128, 512}) {
+        fconv_f32_t *direct = &fconv[0][k];
+        fconv_f32_t *fft = &fconv[1][k++];
+        dsps_fconv_init_f32(direct, y_f32, taps, 256, DSPS_FCONV_DIRECT);
+        dsps_fconv_init_f32(fft, y_f32, taps, 256, DSPS_FCONV_FFT);
+        cases.push_back({"fconv_f32", "direct", taps, 512, [direct]() {
+            dsps_fconv_f32(direct, x_f32, z_f32, 512);
+        }});
+        cases.push_back({"fconv_f32", "fft", taps, 512, [fft]() {
+            dsps_fconv_f32(fft, x_f32, z_f32, 512);
+        }});
+    }
+    cases.push_back({"mul_f32", "ansi", 1024, 1024, []() {
+        dsps_mul_f32_ansi(x_f32, y_f32, z_f32, 1024, 1, 1, 1);
+    }});
+    cases.push_back({"mul_f32", "rv32", 1024, 1024, []() {
+        dsps_mul_f32_rv32(x_f32, y_f32, z_f32, 1024, 1, 1, 1);
+    }});
+    cases.push_back({"add_f32", "ansi", 1024, 1024, []() {
+        dsps_add_f32_ansi(x_f32, y_f32, z_f32, 1024, 1, 1, 1);
+    }});
+    cases.push_back({"add_f32", "rv32", 1024, 1024, []() {
+        dsps_add_f32_rv32(x_f32, y_f32, z_f32, 1024, 1, 1, 1);
+    }});
+    // Matrix multiply: samples are output elements
+    int m = 0;
+    for (int n : {4, 8, 16}) {
+        A[m] = dspm::Mat(x_f32, n, n);
+        B[m] = dspm::Mat(y_f32, n, n);
+        C[m] = dspm::Mat(n, n);
+        dspm::Mat *a = &A[m], *b = &B[m], *c = &C[m];
+        cases.push_back({"dspm_mult_f32", "ansi", n, n * n, [n]() {
+            dspm_mult_f32_ansi(x_f32, y_f32, z_f32, n, n, n);
+        }});
+        cases.push_back({"Mat_operator*", "heap", n, n * n, [a, b]() {
+            dspm::Mat r = (*a) * (*b);
+            sink_f32 = r.data[0];
+        }});
+        cases.push_back({"Mat_mult_add", "fused", n, n * n, [a, b, c]() {
+            dspm::Mat::mult_add(*a, *b, *c, *c, 1, 0);
+        }});
+        m++;
+    }
+    // Orientation filters: samples are filter updates
+    ekf13.Init();
+    MadgwickInit(&madgwick, 0.1f);
+    MahonyInit(&mahony, 1.0f, 0.0f);
+    cases.push_back({"ekf_imu13states", "heap", 13, 1, []() {
+        BenchEkfStep(&ekf13);
+    }});
+    cases.push_back({"ekf_imu13states", "arena", 13, 1, []() {
+        dspm::MatArenaScope scope(&arena);
+        BenchEkfStep(&ekf13);
+    }});
+    cases.push_back({"ImuFusionUpdate", "madgwick", 4, 1, []() {
+        float gyro[3] = {0.01f, -0.02f, 0.005f};
+        float accel[3] = {0.02f, -0.01f, 0.98f};
+        ImuFusionUpdate(&madgwick, gyro, accel, 0.01f);
+    }});
+    cases.push_back({"ImuFusionUpdate", "mahony", 4, 1, []() {
+        float gyro[3] = {0.01f, -0.02f, 0.005f};
+        float accel[3] = {0.02f, -0.01f, 0.98f};
+        ImuFusionUpdate(&mahony, gyro, accel, 0.01f);
+    }});
+    // QRS detector: 64 sample blocks at 250 Hz
+    QrsInit(&qrs, 250);
+    cases.push_back({"QrsProcess", "pan_tompkins", 250, 64, []() {
+        qrs_beat_t beats[4];
+        sink_f32 = QrsProcess(&qrs, x_f32, 64, beats, 4);
+    }});
+    return cases;
+}
+
+// _rv32 kernels against the ANSI reference: dispatch validation for the dispatched
+// operations, direct comparison for the FIR and the s16 dot product
+static int BenchCheck(void){
+    static const char *const op_names[DSPS_DISPATCH_OP_COUNT] = {"dotprod_f32", "mul_f32", "add_f32", "biquad_f32", "fft2r_fc32"};
+    int failures = 0;
+    for (int op = 0; op < DSPS_DISPATCH_OP_COUNT; op++) {
+        bool ok = (dsps_dispatch_override((dsps_dispatch_op_t)op, 0, "rv32") == ESP_OK);
+        dsps_dispatch_override((dsps_dispatch_op_t)op, 0, NULL);
+        printf("%-16s %s\n", op_names[op], ok ? "ok" : "FAIL");
+        failures += !ok;
+    }
+    bool ok = true;
+    for (int taps : {5, 16, 37, 64}) {
+        fir_f32_t fir_ansi, fir_rv32;
+        float delay_ansi[64], delay_rv32[64];
+        dsps_fir_init_f32(&fir_ansi, fir_coeffs, delay_ansi, taps);
+        dsps_fir_init_f32(&fir_rv32, fir_coeffs, delay_rv32, taps);
+        // Two calls: the second one starts with a full delay line
+        for (int call = 0; call < 2; call++) {
+            dsps_fir_f32_ansi(&fir_ansi, x_f32 + call * 255, y_f32, 255);
+            dsps_fir_f32_rv32(&fir_rv32, x_f32 + call * 255, z_f32, 255);
+            for (int i = 0; i < 255; i++) {
+                ok &= (fabsf(y_f32[i] - z_f32[i]) <= 1e-5f * (1 + fabsf(y_f32[i])));
+            }
+        }
+    }
+    printf("%-16s %s\n", "fir_f32", ok ? "ok" : "FAIL");
+    failures += !ok;
+    ok = true;
+    for (int len : {1, 7, 64, 255, 1024}) {
+        for (int shift = 0; shift <= 15; shift += 5) {
+            int16_t ansi, rv32;
+            dsps_dotprod_s16_ansi(x_s16, y_s16, &ansi, len, shift);
+            dsps_dotprod_s16_rv32(x_s16, y_s16, &rv32, len, shift);
+            ok &= (ansi == rv32);
+        }
+    }
+    printf("%-16s %s\n", "dotprod_s16", ok ? "ok" : "FAIL");
+    failures += !ok;
+    return failures;
+}
+
+static void BenchUsage(const char *prog){
+    fprintf(stderr, "usage: %s [--quick] [--dispatch] [--check] [--filter name] [--csv out.csv] [--baseline ref.csv] [--tolerance percent]\n", prog);
+}
+/*==================[external functions definition]==========================*/
+int main(int argc, char **argv){
+    bool quick = false;
+    bool dispatch = false;
+    bool check = false;
+    const char *filter = NULL;
+    const char *csv_path = NULL;
+    const char *baseline_path = NULL;
+    double tolerance = 25;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (strcmp(argv[i], "--dispatch") == 0) {
+            dispatch = true;
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else if ((strcmp(argv[i], "--filter") == 0) && (i + 1 < argc)) {
+            filter = argv[++i];
+        } else if ((strcmp(argv[i], "--csv") == 0) && (i + 1 < argc)) {
+            csv_path = argv[++i];
+        } else if ((strcmp(argv[i], "--baseline") == 0) && (i + 1 < argc)) {
+            baseline_path = argv[++i];
+        } else if ((strcmp(argv[i], "--tolerance") == 0) && (i + 1 < argc)) {
+            tolerance = atof(argv[++i]);
+        } else {
+            BenchUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::map<std::string, bench_result_t> baseline;
+    if (baseline_path != NULL) {
+        baseline = BenchLoadCsv(baseline_path);
+    }
+    FILE *csv = NULL;
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Cannot write %s\n", csv_path);
+            return 2;
+        }
+        fprintf(csv, "name,variant,size,ns_per_sample,allocs_per_call\n");
+    }
+
+    BenchFillInputs();
+    if (!FFTInit()) {
+        fprintf(stderr, "FFTInit failed\n");
+        return 1;
+    }
+    if (check) {
+        int failures = BenchCheck();
+        dsps_fft2r_deinit_fc32();
+        return (failures > 0) ? 1 : 0;
+    }
+    if (dispatch) {
+        // Middleware calls the _auto kernels: select them on this machine first
+        dsps_dispatch_init();
+        dsps_dispatch_print();
+    }
+    std::vector<bench_case_t> cases = BenchCases();
+    int regressions = 0;
+    printf("%-16s %-9s %6s %12s %8s\n", "case", "variant", "size", "ns/sample", "allocs");
+    for (const bench_case_t &c : cases) {
+        if ((filter != NULL) && (c.name.find(filter) == std::string::npos)) {
+            continue;
+        }
+        bench_result_t r = BenchRun(c, quick);
+        printf("%-16s %-9s %6i %12.3f %8.0f", c.name.c_str(), c.variant.c_str(), c.size, r.ns_per_sample, r.allocs_per_call);
+        if (csv != NULL) {
+            fprintf(csv, "%s,%s,%i,%.4f,%.0f\n", c.name.c_str(), c.variant.c_str(), c.size, r.ns_per_sample, r.allocs_per_call);
+        }
+        auto ref = baseline.find(BenchKey(c.name, c.variant, c.size));
+        if (ref != baseline.end()) {
+            double change = 100 * (r.ns_per_sample / ref->second.ns_per_sample - 1);
+            printf(" %+7.1f%%", change);
+            if ((change > tolerance) || (r.allocs_per_call > ref->second.allocs_per_call)) {
+                printf("  REGRESSION");
+                regressions++;
+            }
+        }
+        printf("\n");
+    }
+    if (csv != NULL) {
+        fclose(csv);
+    }
+    // Built with -DDSP_PROFILING=ON: per-call statistics (host "cycles" are ns)
+    DspProfDump();
+    dsps_fft2r_deinit_fc32();
+    if (regressions > 0) {
+        printf("%i regression(s) over %.0f%%\n", regressions, tolerance);
+        return 1;
+    }
+    return 0;
+}
+/*==================[end of file]============================================*/
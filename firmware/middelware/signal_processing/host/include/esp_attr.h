@@ -0,0 +1,12 @@
+/**
+ * @file esp_attr.h
+ * @brief Host stub: memory placement attributes have no meaning off target.
+ */
+#ifndef ESP_ATTR_H_
+#define ESP_ATTR_H_
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+
+#endif /* ESP_ATTR_H_ */
@@ -0,0 +1,22 @@
+/**
+ * @file esp_cpu.h
+ * @brief Host stub of the CPU cycle counter.
+ *
+ * There is no portable cycle counter on the host: the "cycles" are
+ * nanoseconds of the monotonic clock, so dsp_get_cpu_cycle_count()
+ * differences keep their meaning as elapsed time.
+ */
+#ifndef ESP_CPU_H_
+#define ESP_CPU_H_
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint32_t esp_cpu_get_cycle_count(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec);
+}
+
+#endif /* ESP_CPU_H_ */
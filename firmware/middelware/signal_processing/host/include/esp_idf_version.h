@@ -0,0 +1,11 @@
+/**
+ * @file esp_idf_version.h
+ * @brief Host stub: reports the ESP-IDF version the firmware is built with.
+ */
+#ifndef ESP_IDF_VERSION_H_
+#define ESP_IDF_VERSION_H_
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION ESP_IDF_VERSION_VAL(5, 2, 0)
+
+#endif /* ESP_IDF_VERSION_H_ */
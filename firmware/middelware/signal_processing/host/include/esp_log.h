@@ -0,0 +1,42 @@
+/**
+ * @file esp_log.h
+ * @brief Host stub of the ESP-IDF logging macros: printf to stderr.
+ *
+ * Messages above HOST_LOG_LEVEL (default: warnings) are compiled out, so the
+ * benchmark timings do not include logging.
+ *
+ * IDF checks the arguments against the 32 bits target, where size_t is unsigned int
+ * and esp-dsp prints it with %i. The host is LP64, so the stub does not check the
+ * format (host_log_write() has no format attribute): the target build does.
+ */
+#ifndef ESP_LOG_H_
+#define ESP_LOG_H_
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifndef HOST_LOG_LEVEL
+#define HOST_LOG_LEVEL 2    /*!< 1: error, 2: warning, 3: info, 4: debug, 5: verbose */
+#endif
+
+static inline void host_log_write(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+#define HOST_LOG(level, letter, tag, format, ...) do { \
+        if ((level) <= HOST_LOG_LEVEL) { \
+            host_log_write(letter " (%s) " format "\n", tag, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) HOST_LOG(1, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_LOG(2, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_LOG(3, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_LOG(4, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_LOG(5, "V", tag, format, ##__VA_ARGS__)
+
+#endif /* ESP_LOG_H_ */
@@ -0,0 +1,9 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stub: dsp_platform.h includes the FreeRTOS headers, but
+ * nothing built on the host uses the kernel.
+ */
+#ifndef FREERTOS_FREERTOS_H_
+#define FREERTOS_FREERTOS_H_
+
+#endif /* FREERTOS_FREERTOS_H_ */
@@ -0,0 +1,9 @@
+/**
+ * @file portable.h
+ * @brief Host stub: dsp_platform.h includes the FreeRTOS headers, but
+ * nothing built on the host uses the kernel.
+ */
+#ifndef FREERTOS_PORTABLE_H_
+#define FREERTOS_PORTABLE_H_
+
+#endif /* FREERTOS_PORTABLE_H_ */
@@ -0,0 +1,9 @@
+/**
+ * @file semphr.h
+ * @brief Host stub: dsp_platform.h includes the FreeRTOS headers, but
+ * nothing built on the host uses the kernel.
+ */
+#ifndef FREERTOS_SEMPHR_H_
+#define FREERTOS_SEMPHR_H_
+
+#endif /* FREERTOS_SEMPHR_H_ */
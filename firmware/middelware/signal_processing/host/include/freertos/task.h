@@ -0,0 +1,9 @@
+/**
+ * @file task.h
+ * @brief Host stub: dsp_platform.h includes the FreeRTOS headers, but
+ * nothing built on the host uses the kernel.
+ */
+#ifndef FREERTOS_TASK_H_
+#define FREERTOS_TASK_H_
+
+#endif /* FREERTOS_TASK_H_ */
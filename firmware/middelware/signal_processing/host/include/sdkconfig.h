@@ -0,0 +1,16 @@
+/**
+ * @file sdkconfig.h
+ * @brief Host build configuration: the values menuconfig would generate
+ * for the middleware component, with the ANSI kernels selected.
+ */
+#ifndef SDKCONFIG_H_
+#define SDKCONFIG_H_
+
+#define CONFIG_IDF_TARGET "linux"
+#define CONFIG_IDF_TARGET_LINUX 1
+#define CONFIG_DSP_ANSI 1
+#define CONFIG_DSP_OPTIMIZATION 0
+#define CONFIG_DSP_MAX_FFT_SIZE_4096 1
+#define CONFIG_DSP_MAX_FFT_SIZE 4096
+
+#endif /* SDKCONFIG_H_ */
@@ -0,0 +1,166 @@
+#ifndef DSP_PROF_H_
+#define DSP_PROF_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup DSP_Prof DSP profiling
+ */
+
+/** \brief Cycle-count profiling of the esp-dsp entry points and the signal processing middleware
+ *
+ * Enabled with CONFIG_DSP_PROFILING (menuconfig: DSP Library -> Cycle-count profiling).
+ * Every call records the esp_cpu_get_cycle_count() difference in a per-function
+ * histogram (4 buckets per power of two) with 32 bits atomic counters (lock-free on the
+ * RV32IMAC cores, the cycle sum carries into a second counter), so calls from tasks and
+ * ISRs never take a lock. The esp-dsp functions are wrapped when esp_dsp.h is included
+ * (see dsp_prof_wrap.h). The middleware functions are instrumented in their bodies.
+ * Times are inclusive: FFTMagnitude() includes the dsps_* calls it makes.
+ *
+ * When CONFIG_DSP_PROFILING is disabled the macros expand to nothing and the functions
+ * are empty inlines.
+ *
+ * Dump the table with DspProfDump(), or forward the bytes received by the console UART
+ * to DspProfCommand(): 'p' prints the table and 'r' clears it.
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ * | 19/10/2026 | dsps_fconv_f32 (streaming FFT convolution) profiled					|
+ * | 19/10/2026 | QrsProcess (QRS detector) profiled										|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#if CONFIG_DSP_PROFILING
+#include "esp_cpu.h"
+#endif
+/*==================[macros]=================================================*/
+/**
+ * @brief Profiled functions: X(id, name)
+ */
+#define DSP_PROF_FUNCTIONS(X) \
+    X(DSPS_DOTPROD_F32,     "dsps_dotprod_f32")     \
+    X(DSPS_DOTPROD_S16,     "dsps_dotprod_s16")     \
+    X(DSPS_DOTPRODE_F32,    "dsps_dotprode_f32")    \
+    X(DSPS_FIR_F32,         "dsps_fir_f32")         \
+    X(DSPS_FIRD_F32,        "dsps_fird_f32")        \
+    X(DSPS_BIQUAD_F32,      "dsps_biquad_f32")      \
+    X(DSPS_FFT2R_FC32,      "dsps_fft2r_fc32")      \
+    X(DSPS_FFT4R_FC32,      "dsps_fft4r_fc32")      \
+    X(DSPS_BIT_REV_FC32,    "dsps_bit_rev_fc32")    \
+    X(DSPS_CPLX2REC_FC32,   "dsps_cplx2reC_fc32")   \
+    X(DSPS_WIND_HANN_F32,   "dsps_wind_hann_f32")   \
+    X(DSPS_ADD_F32,         "dsps_add_f32")         \
+    X(DSPS_SUB_F32,         "dsps_sub_f32")         \
+    X(DSPS_MUL_F32,         "dsps_mul_f32")         \
+    X(DSPS_ADDC_F32,        "dsps_addc_f32")        \
+    X(DSPS_MULC_F32,        "dsps_mulc_f32")        \
+    X(DSPS_CONV_F32,        "dsps_conv_f32")        \
+    X(DSPS_CORR_F32,        "dsps_corr_f32")        \
+    X(DSPS_FCONV_F32,       "dsps_fconv_f32")       \
+    X(DSPM_MULT_F32,        "dspm_mult_f32")        \
+    X(DSPM_ADD_F32,         "dspm_add_f32")         \
+    X(DSPM_SUB_F32,         "dspm_sub_f32")         \
+    X(FFT_MAGNITUDE,        "FFTMagnitude")         \
+    X(LOW_PASS_FILTER,      "LowPassFilter")        \
+    X(HI_PASS_FILTER,       "HiPassFilter")         \
+    X(IMU_FUSION_UPDATE,    "ImuFusionUpdate")      \
+    X(ORIENTATION_STEP,     "OrientationStep")      \
+    X(QRS_PROCESS,          "QrsProcess")
+
+#define DSP_PROF_ENUM(id, name) DSP_PROF_##id,
+
+#if CONFIG_DSP_PROFILING
+/**
+ * @brief Starts the measurement of a function body (declares the start variable)
+ */
+#define DSP_PROF_BEGIN(start)       uint32_t start = esp_cpu_get_cycle_count()
+/**
+ * @brief Records the cycles elapsed since DSP_PROF_BEGIN(start)
+ */
+#define DSP_PROF_END(id, start)     DspProfRecord(id, start)
+#else
+#define DSP_PROF_BEGIN(start)
+#define DSP_PROF_END(id, start)
+#endif
+/*==================[typedef]================================================*/
+typedef enum dsp_prof_id {
+    DSP_PROF_FUNCTIONS(DSP_PROF_ENUM)
+    DSP_PROF_COUNT
+} dsp_prof_id_t;
+
+/**
+ * @brief Statistics of one profiled function
+ */
+typedef struct {
+	const char *name;	/*!< Function name */
+	uint32_t calls;		/*!< Number of recorded calls */
+	uint32_t min;		/*!< Minimum cycles */
+	uint32_t avg;		/*!< Average cycles */
+	uint32_t p99;		/*!< 99th percentile (histogram bucket upper bound, at most max) */
+	uint32_t max;		/*!< Maximum cycles */
+} dsp_prof_stats_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_DSP_PROFILING
+/**
+ * @brief Records one call of a profiled function
+ *
+ * @param id        Profiled function
+ * @param start     esp_cpu_get_cycle_count() at the start of the call
+ */
+void DspProfRecord(dsp_prof_id_t id, uint32_t start);
+
+/**
+ * @brief Reads the statistics of one profiled function
+ *
+ * @param id        Profiled function
+ * @param stats     Statistics
+ * @return true     The function was called at least once
+ * @return false    No calls recorded
+ */
+bool DspProfGetStats(dsp_prof_id_t id, dsp_prof_stats_t *stats);
+
+/**
+ * @brief Prints min/avg/p99/max cycles of the called functions on the console (UART)
+ */
+void DspProfDump(void);
+
+/**
+ * @brief Clears all the histograms
+ */
+void DspProfReset(void);
+
+/**
+ * @brief Console command: 'p' prints the table (DspProfDump), 'r' clears it (DspProfReset)
+ *
+ * @param cmd       Byte received by the console UART
+ */
+void DspProfCommand(uint8_t cmd);
+#else
+static inline bool DspProfGetStats(dsp_prof_id_t id, dsp_prof_stats_t *stats){ (void)id; (void)stats; return false; }
+static inline void DspProfDump(void){}
+static inline void DspProfReset(void){}
+static inline void DspProfCommand(uint8_t cmd){ (void)cmd; }
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* DSP_PROF_H_ */
+
+/*==================[end of file]============================================*/
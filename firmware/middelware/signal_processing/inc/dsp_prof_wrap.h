@@ -0,0 +1,156 @@
+#ifndef DSP_PROF_WRAP_H_
+#define DSP_PROF_WRAP_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup DSP_Prof DSP profiling
+ ** @{ */
+
+/** \brief Profiling wrappers of the esp-dsp entry points
+ *
+ * Included at the end of esp_dsp.h when CONFIG_DSP_PROFILING is enabled. Each public
+ * name (dsps_fft2r_fc32, dsps_biquad_f32, ...) is redirected to an inline wrapper that
+ * calls the implementation selected by the module header (_ansi, _ae32, _rv32) and
+ * records the elapsed cycles. The dispatched kernels (_auto) are recorded under the same
+ * function. Only the code that includes esp_dsp.h is profiled: calls
+ * between esp-dsp modules (for example from mat.cpp) are not.
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include "dsp_prof.h"
+/*==================[macros]=================================================*/
+/**
+ * @brief Defines the wrapper dsp_prof_<name>(): must be expanded while <name> still
+ * selects the implementation
+ */
+#define DSP_PROF_WRAP(ret, name, id, params, args) \
+    static inline ret dsp_prof_##name params { \
+        uint32_t start = esp_cpu_get_cycle_count(); \
+        ret result = name args; \
+        DspProfRecord(DSP_PROF_##id, start); \
+        return result; \
+    }
+
+#define DSP_PROF_WRAP_VOID(name, id, params, args) \
+    static inline void dsp_prof_##name params { \
+        uint32_t start = esp_cpu_get_cycle_count(); \
+        name args; \
+        DspProfRecord(DSP_PROF_##id, start); \
+    }
+/*==================[wrappers]===============================================*/
+DSP_PROF_WRAP(esp_err_t, dsps_dotprod_f32, DSPS_DOTPROD_F32,
+              (const float *src1, const float *src2, float *dest, int len), (src1, src2, dest, len))
+DSP_PROF_WRAP(esp_err_t, dsps_dotprod_s16, DSPS_DOTPROD_S16,
+              (const int16_t *src1, const int16_t *src2, int16_t *dest, int len, int8_t shift), (src1, src2, dest, len, shift))
+DSP_PROF_WRAP(esp_err_t, dsps_dotprode_f32, DSPS_DOTPRODE_F32,
+              (const float *src1, const float *src2, float *dest, int len, int step1, int step2), (src1, src2, dest, len, step1, step2))
+DSP_PROF_WRAP(esp_err_t, dsps_fir_f32, DSPS_FIR_F32,
+              (fir_f32_t *fir, const float *input, float *output, int len), (fir, input, output, len))
+DSP_PROF_WRAP(int, dsps_fird_f32, DSPS_FIRD_F32,
+              (fir_f32_t *fir, const float *input, float *output, int len), (fir, input, output, len))
+DSP_PROF_WRAP(esp_err_t, dsps_biquad_f32, DSPS_BIQUAD_F32,
+              (const float *input, float *output, int len, float *coef, float *w), (input, output, len, coef, w))
+DSP_PROF_WRAP(esp_err_t, dsps_fft2r_fc32, DSPS_FFT2R_FC32, (float *data, int N), (data, N))
+DSP_PROF_WRAP(esp_err_t, dsps_fft4r_fc32, DSPS_FFT4R_FC32, (float *data, int N), (data, N))
+DSP_PROF_WRAP(esp_err_t, dsps_bit_rev_fc32, DSPS_BIT_REV_FC32, (float *data, int N), (data, N))
+DSP_PROF_WRAP(esp_err_t, dsps_cplx2reC_fc32, DSPS_CPLX2REC_FC32, (float *data, int N), (data, N))
+DSP_PROF_WRAP_VOID(dsps_wind_hann_f32, DSPS_WIND_HANN_F32, (float *window, int len), (window, len))
+DSP_PROF_WRAP(esp_err_t, dsps_add_f32, DSPS_ADD_F32,
+              (const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out),
+              (input1, input2, output, len, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_sub_f32, DSPS_SUB_F32,
+              (const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out),
+              (input1, input2, output, len, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_mul_f32, DSPS_MUL_F32,
+              (const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out),
+              (input1, input2, output, len, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_addc_f32, DSPS_ADDC_F32,
+              (const float *input, float *output, int len, float C, int step_in, int step_out), (input, output, len, C, step_in, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_mulc_f32, DSPS_MULC_F32,
+              (const float *input, float *output, int len, float C, int step_in, int step_out), (input, output, len, C, step_in, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_conv_f32, DSPS_CONV_F32,
+              (const float *Signal, const int siglen, const float *Kernel, const int kernlen, float *convout),
+              (Signal, siglen, Kernel, kernlen, convout))
+DSP_PROF_WRAP(esp_err_t, dsps_corr_f32, DSPS_CORR_F32,
+              (const float *Signal, const int siglen, const float *Pattern, const int patlen, float *dest),
+              (Signal, siglen, Pattern, patlen, dest))
+DSP_PROF_WRAP(esp_err_t, dsps_fconv_f32, DSPS_FCONV_F32,
+              (fconv_f32_t *conv, const float *input, float *output, int len), (conv, input, output, len))
+DSP_PROF_WRAP(esp_err_t, dspm_mult_f32, DSPM_MULT_F32,
+              (const float *A, const float *B, float *C, int m, int n, int k), (A, B, C, m, n, k))
+DSP_PROF_WRAP(esp_err_t, dspm_add_f32, DSPM_ADD_F32,
+              (const float *input1, const float *input2, float *output, int rows, int cols, int padd1, int padd2, int padd_out, int step1, int step2, int step_out),
+              (input1, input2, output, rows, cols, padd1, padd2, padd_out, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dspm_sub_f32, DSPM_SUB_F32,
+              (const float *input1, const float *input2, float *output, int rows, int cols, int padd1, int padd2, int padd_out, int step1, int step2, int step_out),
+              (input1, input2, output, rows, cols, padd1, padd2, padd_out, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_dotprod_f32_auto, DSPS_DOTPROD_F32,
+              (const float *src1, const float *src2, float *dest, int len), (src1, src2, dest, len))
+DSP_PROF_WRAP(esp_err_t, dsps_mul_f32_auto, DSPS_MUL_F32,
+              (const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out),
+              (input1, input2, output, len, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_add_f32_auto, DSPS_ADD_F32,
+              (const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out),
+              (input1, input2, output, len, step1, step2, step_out))
+DSP_PROF_WRAP(esp_err_t, dsps_biquad_f32_auto, DSPS_BIQUAD_F32,
+              (const float *input, float *output, int len, float *coef, float *w), (input, output, len, coef, w))
+DSP_PROF_WRAP(esp_err_t, dsps_fft2r_fc32_auto, DSPS_FFT2R_FC32, (float *data, int N), (data, N))
+
+/*==================[redirection of the public names]========================*/
+#undef dsps_dotprod_f32
+#define dsps_dotprod_f32    dsp_prof_dsps_dotprod_f32
+#undef dsps_dotprod_s16
+#define dsps_dotprod_s16    dsp_prof_dsps_dotprod_s16
+#undef dsps_dotprode_f32
+#define dsps_dotprode_f32   dsp_prof_dsps_dotprode_f32
+#undef dsps_fir_f32
+#define dsps_fir_f32        dsp_prof_dsps_fir_f32
+#undef dsps_fird_f32
+#define dsps_fird_f32       dsp_prof_dsps_fird_f32
+#undef dsps_biquad_f32
+#define dsps_biquad_f32     dsp_prof_dsps_biquad_f32
+#undef dsps_fft2r_fc32
+#define dsps_fft2r_fc32     dsp_prof_dsps_fft2r_fc32
+#undef dsps_fft4r_fc32
+#define dsps_fft4r_fc32     dsp_prof_dsps_fft4r_fc32
+#undef dsps_bit_rev_fc32
+#define dsps_bit_rev_fc32   dsp_prof_dsps_bit_rev_fc32
+#undef dsps_cplx2reC_fc32
+#define dsps_cplx2reC_fc32  dsp_prof_dsps_cplx2reC_fc32
+#define dsps_wind_hann_f32  dsp_prof_dsps_wind_hann_f32
+#undef dsps_add_f32
+#define dsps_add_f32        dsp_prof_dsps_add_f32
+#undef dsps_sub_f32
+#define dsps_sub_f32        dsp_prof_dsps_sub_f32
+#undef dsps_mul_f32
+#define dsps_mul_f32        dsp_prof_dsps_mul_f32
+#undef dsps_addc_f32
+#define dsps_addc_f32       dsp_prof_dsps_addc_f32
+#undef dsps_mulc_f32
+#define dsps_mulc_f32       dsp_prof_dsps_mulc_f32
+#undef dsps_conv_f32
+#define dsps_conv_f32       dsp_prof_dsps_conv_f32
+#undef dsps_corr_f32
+#define dsps_corr_f32       dsp_prof_dsps_corr_f32
+#undef dspm_mult_f32
+#define dspm_mult_f32       dsp_prof_dspm_mult_f32
+#undef dspm_add_f32
+#define dspm_add_f32        dsp_prof_dspm_add_f32
+#undef dspm_sub_f32
+#define dspm_sub_f32        dsp_prof_dspm_sub_f32
+// Real functions: no #undef
+#define dsps_fconv_f32          dsp_prof_dsps_fconv_f32
+#define dsps_dotprod_f32_auto   dsp_prof_dsps_dotprod_f32_auto
+#define dsps_mul_f32_auto       dsp_prof_dsps_mul_f32_auto
+#define dsps_add_f32_auto       dsp_prof_dsps_add_f32_auto
+#define dsps_biquad_f32_auto    dsp_prof_dsps_biquad_f32_auto
+#define dsps_fft2r_fc32_auto    dsp_prof_dsps_fft2r_fc32_auto
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* DSP_PROF_WRAP_H_ */
+
+/*==================[end of file]============================================*/
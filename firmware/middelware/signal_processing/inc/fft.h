@@ -16,6 +16,8 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 15/03/2024 | Document creation		                         						|
+ * | 19/10/2026 | Cycle-count profiling with CONFIG_DSP_PROFILING (dsp_prof.h)			|
+ * | 19/10/2026 | Kernels called through the dispatch table (dsps_dispatch.h)			|
  * 
  **/
 
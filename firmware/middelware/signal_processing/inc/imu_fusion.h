@@ -0,0 +1,118 @@
+#ifndef IMU_FUSION_H_
+#define IMU_FUSION_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup IMU_Fusion IMU Fusion
+ */
+
+/** \brief Quaternion complementary filters (Madgwick and Mahony) for 6 axis IMUs.
+ *
+ * Low cost alternative to the 13 states EKF: the filter state is a fixed size structure
+ * (no heap allocations) and each update is a few dozen floating point operations.
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+/*==================[macros]=================================================*/
+#define MADGWICK_BETA_DEFAULT   0.1f    /*!< Madgwick gradient descent gain */
+#define MAHONY_KP_DEFAULT       1.0f    /*!< Mahony proportional gain */
+#define MAHONY_KI_DEFAULT       0.0f    /*!< Mahony integral gain (0: no gyro bias estimation) */
+/*==================[typedef]================================================*/
+typedef enum fusion_type {
+    FUSION_MADGWICK,            /*!< Madgwick gradient descent filter */
+    FUSION_MAHONY               /*!< Mahony PI complementary filter */
+} fusion_type_t;
+
+/**
+ * @brief Filter state
+ */
+typedef struct {
+    fusion_type_t type;         /*!< Filter variant */
+    float q[4];                 /*!< Attitude quaternion (w, x, y, z) */
+    float beta;                 /*!< Madgwick gain */
+    float kp;                   /*!< Mahony proportional gain */
+    float ki;                   /*!< Mahony integral gain */
+    float integral[3];          /*!< Mahony integral feedback in rad/s (opposite of the gyro bias) */
+    float accel_scale;          /*!< g per LSB of raw accelerometer data */
+    float gyro_scale;           /*!< rad/s per LSB of raw gyroscope data */
+} imu_fusion_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @brief Initialize a Madgwick filter (identity attitude)
+ *
+ * @param filter    Filter state
+ * @param beta      Gradient descent gain (MADGWICK_BETA_DEFAULT)
+ */
+void MadgwickInit(imu_fusion_t *filter, float beta);
+
+/**
+ * @brief Initialize a Mahony filter (identity attitude)
+ *
+ * @param filter    Filter state
+ * @param kp        Proportional gain (MAHONY_KP_DEFAULT)
+ * @param ki        Integral gain (MAHONY_KI_DEFAULT)
+ */
+void MahonyInit(imu_fusion_t *filter, float kp, float ki);
+
+/**
+ * @brief Set the scale of raw data used by ImuFusionUpdateMotion6()
+ *
+ * @param filter        Filter state
+ * @param accel_lsb     Accelerometer LSB per g (16384 for MPU6050 +/- 2g)
+ * @param gyro_lsb      Gyroscope LSB per degree/s (131 for MPU6050 +/- 250 degrees/s)
+ */
+void ImuFusionSetScale(imu_fusion_t *filter, float accel_lsb, float gyro_lsb);
+
+/**
+ * @brief Update the attitude with one IMU sample
+ *
+ * @param filter    Filter state
+ * @param gyro      Angular rate (x, y, z) in rad/s
+ * @param accel     Acceleration (x, y, z) in any unit (it is normalized)
+ * @param dt        Time since the last update in seconds
+ */
+void ImuFusionUpdate(imu_fusion_t *filter, const float *gyro, const float *accel, float dt);
+
+/**
+ * @brief Update the attitude with raw data as returned by MPU6050_getMotion6()
+ *
+ * @param filter    Filter state
+ * @param ax, ay, az    Raw acceleration
+ * @param gx, gy, gz    Raw angular rate
+ * @param dt        Time since the last update in seconds
+ */
+void ImuFusionUpdateMotion6(imu_fusion_t *filter, int16_t ax, int16_t ay, int16_t az,
+                            int16_t gx, int16_t gy, int16_t gz, float dt);
+
+/**
+ * @brief Yaw, pitch and roll angles of the current attitude
+ *
+ * @param filter    Filter state
+ * @param ypr       Container for the angles in radians
+ */
+void ImuFusionGetYawPitchRoll(const imu_fusion_t *filter, float *ypr);
+#ifdef __cplusplus
+}
+#endif
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* IMU_FUSION_H_ */
+
+/*==================[end of file]============================================*/
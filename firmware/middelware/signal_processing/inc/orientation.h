@@ -0,0 +1,125 @@
+#ifndef ORIENTATION_H_
+#define ORIENTATION_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup Orientation Orientation
+ */
+
+/** \brief Attitude estimation service: MPU6050 FIFO samples fused by the 13 states EKF
+ * (ekf_imu13states) or by a Madgwick/Mahony filter (imu_fusion) in a dedicated task.
+ *
+ * The MPU6050 FIFO acquisition delivers one batch of samples per filter update. The batch
+ * is averaged and handed (by a one element mailbox) to the orientation task, which runs
+ * Process() and UpdateRefMeasurement() with a fixed dt. The result is published in a
+ * lock-free latest-value slot: readers never block the filter. The matrix temporaries of
+ * an EKF update are taken from a preallocated arena released after each update.
+ *
+ * @note The MPU6050 has no magnetometer: the magnetometer measurement is replaced by the
+ * value expected by the filter (no heading correction, yaw drifts with the gyro bias).
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ * | 19/10/2026 | Madgwick and Mahony filters as alternatives to the EKF				|
+ * | 19/10/2026 | EKF matrix temporaries taken from an arena (no heap in the loop)		|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_mcu.h"
+/*==================[macros]=================================================*/
+#define ORIENTATION_TASK_STACK      4096    /*!< Stack size of the orientation task */
+#define ORIENTATION_ACCEL_R         0.01f   /*!< Default accelerometer measurement variance */
+#define ORIENTATION_ARENA_SIZE      6144    /*!< Bytes for the EKF matrix temporaries of one update (about 4.9 KB used) */
+/*==================[typedef]================================================*/
+typedef enum orientation_filter {
+    ORIENTATION_EKF,            /*!< 13 states EKF (ekf_imu13states) */
+    ORIENTATION_MADGWICK,       /*!< Madgwick filter */
+    ORIENTATION_MAHONY          /*!< Mahony filter */
+} orientation_filter_t;
+
+/**
+ * @brief Attitude estimation
+ */
+typedef struct {
+	float q[4];				/*!< Attitude quaternion (w, x, y, z) */
+	float gyro_bias[3];		/*!< Estimated gyroscope bias in rad/s */
+	int64_t timestamp;		/*!< Time of the last sample used in us */
+	uint32_t updates;		/*!< Number of filter updates */
+} attitude_t;
+
+/**
+ * @brief Orientation service configuration
+ */
+typedef struct {
+	orientation_filter_t filter;	/*!< Fusion filter */
+	gpio_t int_pin;			/*!< GPIO connected to the MPU6050 INT pin */
+	uint16_t sample_rate;	/*!< IMU sample rate in Hz */
+	uint16_t update_rate;	/*!< Filter update rate in Hz (a divisor of sample_rate) */
+	uint8_t task_priority;	/*!< Orientation task priority (the acquisition task uses one more) */
+	float accel_r;			/*!< EKF accelerometer measurement variance (0: ORIENTATION_ACCEL_R) */
+} orientation_config_t;
+
+/**
+ * @brief Filter update cost
+ */
+typedef struct {
+	uint32_t iterations;	/*!< Updates measured */
+	uint32_t min_cycles;	/*!< Minimum CPU cycles per update */
+	uint32_t avg_cycles;	/*!< Average CPU cycles per update */
+	uint32_t max_cycles;	/*!< Maximum CPU cycles per update */
+	uint32_t max_rate;		/*!< Maximum sustainable update rate in Hz (whole CPU, average cost) */
+	uint32_t arena_peak;	/*!< EKF: peak bytes of matrix temporaries in one update */
+	uint32_t arena_overflows;	/*!< EKF: temporaries that did not fit in the arena (heap allocations) */
+} orientation_bench_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @brief Initialize the filter and start the MPU6050 FIFO acquisition and the orientation task
+ *
+ * @note MPU6050_initialize() must be called before.
+ * @param config    Service configuration
+ * @return true     Service started
+ * @return false    Invalid configuration (update_rate not a divisor of sample_rate, or more than
+ *                  MPU6050_FIFO_MAX_SAMPLES samples per update) or not enough memory
+ */
+bool OrientationInit(orientation_config_t *config);
+
+/**
+ * @brief Read the latest attitude estimation (lock-free, it can be called from any task)
+ *
+ * @param attitude  Container for the attitude
+ * @return true     Attitude copied
+ * @return false    No update was published yet
+ */
+bool OrientationGet(attitude_t *attitude);
+
+/**
+ * @brief Measure the cost of a filter update with synthetic data, on a private filter instance
+ * (EKF: Process + UpdateRefMeasurement)
+ *
+ * @param filter        Fusion filter
+ * @param iterations    Number of updates to measure
+ * @param result        Container for the result
+ */
+void OrientationBenchmark(orientation_filter_t filter, uint32_t iterations, orientation_bench_t *result);
+#ifdef __cplusplus
+}
+#endif
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* ORIENTATION_H_ */
+
+/*==================[end of file]============================================*/
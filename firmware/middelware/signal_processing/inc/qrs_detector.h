@@ -0,0 +1,149 @@
+#ifndef QRS_DETECTOR_H_
+#define QRS_DETECTOR_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup QRS_Detector QRS detector
+ */
+
+/** \brief Streaming Pan-Tompkins QRS detector and heart rate estimator.
+ *
+ * The ECG is processed in blocks of any length (for example one block per ADC read):
+ * 5-15 Hz band-pass (two biquads), five point derivative (FIR), squaring, 150 ms moving
+ * window integration and adaptive thresholds on the integrated signal, with a 200 ms
+ * refractory period, T wave discrimination and search back after 1.66 average RR
+ * intervals without a beat.
+ *
+ * Each beat reports the sample index of the R peak (maximum of the band-passed signal in
+ * the integration window, so leads with a positive R wave) and the instantaneous heart
+ * rate. Beats are reported about one integration window after the R peak, search back
+ * beats up to 1.66 RR later. The first 2 s train the thresholds and report no beats: if
+ * they contain no QRS (heart rate under 30 bpm) the first beat may be a false detection.
+ *
+ * The detector state is a fixed size structure (no heap allocations), so several
+ * channels can be processed in parallel. The filters are independent of the
+ * LowPassFilter()/HiPassFilter() instance.
+ *
+ * Reference: J. Pan, W. J. Tompkins, "A Real-Time QRS Detection Algorithm",
+ * IEEE Trans. Biomed. Eng. 32(3), 1985.
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsps_fir.h"
+/*==================[macros]=================================================*/
+#define QRS_FREQ_MIN        50      /*!< Minimum sample frequency in Hz */
+#define QRS_FREQ_MAX        1000    /*!< Maximum sample frequency in Hz */
+#define QRS_HISTORY_LEN     160     /*!< Integration window plus derivative delay at QRS_FREQ_MAX */
+#define QRS_DERIVATIVE_LEN  8       /*!< Derivative taps (5 point derivative padded to a multiple of 4) */
+#define QRS_RR_AVERAGE      8       /*!< RR intervals in the average */
+/*==================[typedef]================================================*/
+/**
+ * @brief Detected beat
+ */
+typedef struct {
+    uint32_t sample;            /*!< Sample index of the R peak since QrsInit() */
+    float rr;                   /*!< RR interval in s (0 for the first beat) */
+    float heart_rate;           /*!< Instantaneous heart rate in beats per minute (0 for the first beat) */
+} qrs_beat_t;
+
+/**
+ * @brief Detector state
+ */
+typedef struct {
+    float sample_freq;                      /*!< Sample frequency in Hz */
+    uint16_t window;                        /*!< Integration window in samples */
+    uint16_t refractory;                    /*!< Refractory period in samples */
+    uint16_t t_wave;                        /*!< T wave discrimination interval in samples */
+    uint32_t learn;                         /*!< Threshold training length in samples */
+    float hp_coeffs[5];                     /*!< Band-pass: high pass biquad */
+    float hp_delay[2];
+    float lp_coeffs[5];                     /*!< Band-pass: low pass biquad */
+    float lp_delay[2];
+    fir_f32_t derivative;                   /*!< Derivative filter */
+    float derivative_coeffs[QRS_DERIVATIVE_LEN];
+    float derivative_delay[QRS_DERIVATIVE_LEN + 4];
+    float filtered[QRS_HISTORY_LEN];        /*!< Band-passed history (R peak search) */
+    uint16_t filtered_pos;
+    float squared[QRS_HISTORY_LEN];         /*!< Squared derivative in the integration window */
+    uint16_t squared_pos;
+    float mwi_sum;                          /*!< Sum of squared[] */
+    float mwi_last;                         /*!< Last integrated sample */
+    bool rising;                            /*!< Integrated signal rising */
+    float learn_max;                        /*!< Training: maximum of the integrated signal */
+    float learn_sum;                        /*!< Training: sum of the integrated signal */
+    float spki;                             /*!< Signal peak level */
+    float npki;                             /*!< Noise peak level */
+    float threshold1;                       /*!< Detection threshold */
+    float threshold2;                       /*!< Search back threshold */
+    uint32_t count;                         /*!< Samples processed */
+    bool beat;                              /*!< At least one beat detected */
+    uint32_t last_peak;                     /*!< Integrated signal peak of the last beat */
+    uint32_t last_r;                        /*!< R peak of the last beat */
+    float last_slope;                       /*!< Maximum squared slope of the last beat */
+    uint32_t rr[QRS_RR_AVERAGE];            /*!< Last RR intervals in samples */
+    uint8_t rr_count;
+    uint8_t rr_pos;
+    float rr_average;                       /*!< Average RR interval in samples (0: unknown) */
+    float candidate;                        /*!< Search back: highest noise peak above threshold2 */
+    uint32_t candidate_peak;
+    uint32_t candidate_r;
+    float candidate_slope;
+} qrs_detector_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @brief Initialize a detector
+ *
+ * @param qrs           Detector state
+ * @param sample_freq   Sample frequency in Hz, QRS_FREQ_MIN to QRS_FREQ_MAX (200 Hz or more recommended)
+ * @return false if the sample frequency is out of range
+ */
+bool QrsInit(qrs_detector_t *qrs, float sample_freq);
+
+/**
+ * @brief Process a block of ECG samples
+ *
+ * The DC level of the first sample is removed without a filter transient, so raw ADC
+ * values in mV can be used.
+ *
+ * @param qrs           Detector state
+ * @param signal        ECG samples, any unit
+ * @param signal_lenght Number of samples
+ * @param beats         Container for the beats detected in this block
+ * @param max_beats     Size of beats; further beats are tracked but not reported
+ * @return Number of beats in beats
+ */
+uint8_t QrsProcess(qrs_detector_t *qrs, const float *signal, uint16_t signal_lenght,
+                   qrs_beat_t *beats, uint8_t max_beats);
+
+/**
+ * @brief Heart rate averaged over the last QRS_RR_AVERAGE beats
+ *
+ * @param qrs           Detector state
+ * @return Heart rate in beats per minute, 0 before the second beat
+ */
+float QrsHeartRate(const qrs_detector_t *qrs);
+#ifdef __cplusplus
+}
+#endif
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* QRS_DETECTOR_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,161 @@
+/**
+ * @file dsp_prof.c
+ * @brief Lock-free cycle-count histograms of the profiled DSP functions
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "dsp_prof.h"
+#if CONFIG_DSP_PROFILING
+/*==================[macros and definitions]=================================*/
+#define PROF_SUB_BITS       2                           /*!< 2^PROF_SUB_BITS buckets per power of two */
+#define PROF_SUB_BUCKETS    (1 << PROF_SUB_BITS)
+#define PROF_BUCKETS        ((32 - PROF_SUB_BITS + 1) << PROF_SUB_BITS)
+#define PROF_NAME(id, name) name,
+
+typedef struct {
+	uint32_t calls;
+	uint32_t min;
+	uint32_t max;
+	uint32_t sum;		/*!< Cycles, low 32 bits: 64 bits atomics are not lock-free on RV32 */
+	uint32_t sum_wraps;	/*!< Cycles, high 32 bits (overflows of sum) */
+	uint32_t hist[PROF_BUCKETS];
+} prof_entry_t;
+/*==================[internal data declaration]==============================*/
+static prof_entry_t prof_table[DSP_PROF_COUNT];
+static const char *const prof_names[DSP_PROF_COUNT] = {
+    DSP_PROF_FUNCTIONS(PROF_NAME)
+};
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Histogram bucket of a cycle count: exact below PROF_SUB_BUCKETS, then
+ * PROF_SUB_BUCKETS buckets per power of two (at most 25% wide)
+ */
+static inline uint32_t ProfBucket(uint32_t cycles);
+
+/**
+ * @brief Largest cycle count of a bucket
+ */
+static uint32_t ProfBucketUpper(uint32_t bucket);
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static inline uint32_t ProfBucket(uint32_t cycles){
+    if(cycles < PROF_SUB_BUCKETS){
+        return cycles;
+    }
+    uint32_t msb = 31 - __builtin_clz(cycles);
+    uint32_t sub = (cycles >> (msb - PROF_SUB_BITS)) & (PROF_SUB_BUCKETS - 1);
+    return ((msb - PROF_SUB_BITS + 1) << PROF_SUB_BITS) | sub;
+}
+
+static uint32_t ProfBucketUpper(uint32_t bucket){
+    if(bucket < PROF_SUB_BUCKETS){
+        return bucket;
+    }
+    uint32_t shift = (bucket >> PROF_SUB_BITS) - 1;
+    uint64_t lower = (uint64_t)(PROF_SUB_BUCKETS | (bucket & (PROF_SUB_BUCKETS - 1))) << shift;
+    uint64_t upper = lower + (1ULL << shift) - 1;
+    return (upper > UINT32_MAX) ? UINT32_MAX : (uint32_t)upper;
+}
+/*==================[external functions definition]==========================*/
+void DspProfRecord(dsp_prof_id_t id, uint32_t start){
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    prof_entry_t *entry = &prof_table[id];
+    // Relaxed atomics: the counters are independent, a dump running concurrently
+    // may see a call in calls but not yet in the histogram
+    __atomic_fetch_add(&entry->calls, 1, __ATOMIC_RELAXED);
+    if(__atomic_fetch_add(&entry->sum, cycles, __ATOMIC_RELAXED) > UINT32_MAX - cycles){
+        __atomic_fetch_add(&entry->sum_wraps, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&entry->hist[ProfBucket(cycles)], 1, __ATOMIC_RELAXED);
+    uint32_t seen = __atomic_load_n(&entry->min, __ATOMIC_RELAXED);
+    while(((seen == 0) || (cycles < seen)) &&
+          !__atomic_compare_exchange_n(&entry->min, &seen, cycles, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    }
+    seen = __atomic_load_n(&entry->max, __ATOMIC_RELAXED);
+    while((cycles > seen) &&
+          !__atomic_compare_exchange_n(&entry->max, &seen, cycles, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    }
+}
+
+bool DspProfGetStats(dsp_prof_id_t id, dsp_prof_stats_t *stats){
+    prof_entry_t *entry = &prof_table[id];
+    uint32_t calls = __atomic_load_n(&entry->calls, __ATOMIC_RELAXED);
+    memset(stats, 0, sizeof(dsp_prof_stats_t));
+    stats->name = prof_names[id];
+    if(calls == 0){
+        return false;
+    }
+    stats->calls = calls;
+    stats->min = __atomic_load_n(&entry->min, __ATOMIC_RELAXED);
+    stats->max = __atomic_load_n(&entry->max, __ATOMIC_RELAXED);
+    // The carry of a concurrent call may be missing: the average is off for that dump only
+    uint32_t wraps, sum;
+    do{
+        wraps = __atomic_load_n(&entry->sum_wraps, __ATOMIC_RELAXED);
+        sum = __atomic_load_n(&entry->sum, __ATOMIC_RELAXED);
+    } while(wraps != __atomic_load_n(&entry->sum_wraps, __ATOMIC_RELAXED));
+    stats->avg = (uint32_t)((((uint64_t)wraps << 32) | sum) / calls);
+    // 99th percentile: first bucket where the cumulative count reaches 99% of the calls
+    uint32_t target = calls - calls / 100;
+    uint32_t cumulative = 0;
+    for(uint32_t b = 0; b < PROF_BUCKETS; b++){
+        cumulative += __atomic_load_n(&entry->hist[b], __ATOMIC_RELAXED);
+        if(cumulative >= target){
+            stats->p99 = ProfBucketUpper(b);
+            break;
+        }
+    }
+    if((stats->p99 == 0) || (stats->p99 > stats->max)){
+        stats->p99 = stats->max;
+    }
+    return true;
+}
+
+void DspProfDump(void){
+    dsp_prof_stats_t stats;
+    printf("%-20s %10s %10s %10s %10s %10s\n", "function", "calls", "min", "avg", "p99", "max");
+    for(uint32_t id = 0; id < DSP_PROF_COUNT; id++){
+        if(DspProfGetStats((dsp_prof_id_t)id, &stats)){
+            printf("%-20s %10lu %10lu %10lu %10lu %10lu\n", stats.name, (unsigned long)stats.calls,
+                   (unsigned long)stats.min, (unsigned long)stats.avg, (unsigned long)stats.p99, (unsigned long)stats.max);
+        }
+    }
+}
+
+void DspProfReset(void){
+    // Not atomic as a whole: calls recorded during the reset may be partially kept
+    for(uint32_t id = 0; id < DSP_PROF_COUNT; id++){
+        prof_entry_t *entry = &prof_table[id];
+        __atomic_store_n(&entry->calls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->sum, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->sum_wraps, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->min, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->max, 0, __ATOMIC_RELAXED);
+        for(uint32_t b = 0; b < PROF_BUCKETS; b++){
+            __atomic_store_n(&entry->hist[b], 0, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void DspProfCommand(uint8_t cmd){
+    switch(cmd){
+        case 'p':
+            DspProfDump();
+        break;
+        case 'r':
+            DspProfReset();
+        break;
+    }
+}
+#endif /* CONFIG_DSP_PROFILING */
+/*==================[end of file]============================================*/
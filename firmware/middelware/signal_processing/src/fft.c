@@ -15,6 +15,7 @@
 #include "fft.h"
 #include "esp_dsp.h"
 #include "esp_log.h"
+#include "dsp_prof.h"
 /*==================[macros and definitions]=================================*/
 #define TAG "FFT Module"
 /*==================[internal data declaration]==============================*/
@@ -38,14 +39,15 @@ bool FFTInit(void){
 }
 
 void FFTMagnitude(float * signal, float * fft, uint16_t signal_lenght){
+    DSP_PROF_BEGIN(prof_start);
     // Generate Hann window
     dsps_wind_hann_f32(wind, signal_lenght);
     // Clear fft array
     memset(fft_complex, 0, 2 * MAX_SIGNAL_LENGHT * sizeof(float));
     // Multiply input array with window and store as real part
-    dsps_mul_f32(signal, wind, fft_complex, signal_lenght, 1, 1, 2);    
+    dsps_mul_f32_auto(signal, wind, fft_complex, signal_lenght, 1, 1, 2);    
     // Calculate FFT  
-    dsps_fft2r_fc32(fft_complex, signal_lenght);
+    dsps_fft2r_fc32_auto(fft_complex, signal_lenght);
     // Bit reverse
     dsps_bit_rev_fc32(fft_complex, signal_lenght);
     // Convert one complex vector to two complex vectors
@@ -57,6 +59,7 @@ void FFTMagnitude(float * signal, float * fft, uint16_t signal_lenght){
     fft_complex[0] = fft_complex[0] / 2;
     // Copy result in fft array
     memcpy(fft, fft_complex, (signal_lenght / 2) * sizeof(float));
+    DSP_PROF_END(DSP_PROF_FFT_MAGNITUDE, prof_start);
 }
 
 void FFTFrequency(float sample_freq, uint16_t signal_lenght, float * f){
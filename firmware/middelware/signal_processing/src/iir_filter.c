@@ -12,6 +12,7 @@
 /*==================[inclusions]=============================================*/
 #include "iir_filter.h"
 #include "esp_dsp.h"
+#include "dsp_prof.h"
 /*==================[macros and definitions]=================================*/
 #define N_SOS       5
 #define N_DELAY     2
@@ -108,49 +109,53 @@ void HiPassInit(float sample_frec, float cut_frec, filter_order_t order){
 }
 
 void LowPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
+    DSP_PROF_BEGIN(prof_start);
     switch(lp_order){
         case ORDER_2:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
         break;
         case ORDER_4:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
         break;
         case ORDER_6:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp6_sos_coeff, lp6_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, lp6_sos_coeff, lp6_delay);
         break;
         case ORDER_8:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp6_sos_coeff, lp6_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp8_sos_coeff, lp8_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, lp6_sos_coeff, lp6_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, lp8_sos_coeff, lp8_delay);
         break;
     }
+    DSP_PROF_END(DSP_PROF_LOW_PASS_FILTER, prof_start);
 }
 
 void HiPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
+    DSP_PROF_BEGIN(prof_start);
     switch(hp_order){
         case ORDER_2:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
         break;
         case ORDER_4:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
         break;
         case ORDER_6:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp6_sos_coeff, hp6_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, hp6_sos_coeff, hp6_delay);
         break;
         case ORDER_8:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp6_sos_coeff, hp6_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp8_sos_coeff, hp8_delay);
+            dsps_biquad_f32_auto(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, hp6_sos_coeff, hp6_delay);
+            dsps_biquad_f32_auto(output_signal, output_signal, signal_lenght, hp8_sos_coeff, hp8_delay);
         break;
     }
+    DSP_PROF_END(DSP_PROF_HI_PASS_FILTER, prof_start);
 }
 
 /*==================[end of file]============================================*/
\ No newline at end of file
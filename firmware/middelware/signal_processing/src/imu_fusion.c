@@ -0,0 +1,160 @@
+/**
+ * @file imu_fusion.c
+ * @brief Madgwick and Mahony quaternion filters
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <string.h>
+#include <math.h>
+#include "imu_fusion.h"
+#include "dsp_prof.h"
+/*==================[macros and definitions]=================================*/
+#define DEG_TO_RAD      ((float)M_PI / 180.0f)
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Normalize a vector in place
+ * @return false if the vector is null
+ */
+static bool Normalize(float *v, uint8_t n);
+
+static void MadgwickUpdate(imu_fusion_t *filter, const float *gyro, const float *accel, float dt);
+
+static void MahonyUpdate(imu_fusion_t *filter, const float *gyro, const float *accel, float dt);
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static bool Normalize(float *v, uint8_t n){
+    float norm = 0;
+    for(uint8_t i = 0; i < n; i++){
+        norm += v[i] * v[i];
+    }
+    if(norm == 0){
+        return false;
+    }
+    norm = 1.0f / sqrtf(norm);
+    for(uint8_t i = 0; i < n; i++){
+        v[i] *= norm;
+    }
+    return true;
+}
+
+static void MadgwickUpdate(imu_fusion_t *filter, const float *gyro, const float *accel, float dt){
+    float *q = filter->q;
+    float a[3] = {accel[0], accel[1], accel[2]};
+    float s[4];
+    // Rate of change of quaternion from gyroscope
+    float qdot[4] = {
+        0.5f * (-q[1] * gyro[0] - q[2] * gyro[1] - q[3] * gyro[2]),
+        0.5f * ( q[0] * gyro[0] + q[2] * gyro[2] - q[3] * gyro[1]),
+        0.5f * ( q[0] * gyro[1] - q[1] * gyro[2] + q[3] * gyro[0]),
+        0.5f * ( q[0] * gyro[2] + q[1] * gyro[1] - q[2] * gyro[0])
+    };
+    if(Normalize(a, 3)){
+        // Gradient descent step on the gravity direction error
+        float q0q0 = q[0] * q[0], q1q1 = q[1] * q[1], q2q2 = q[2] * q[2], q3q3 = q[3] * q[3];
+        s[0] = 4.0f * q[0] * q2q2 + 2.0f * q[2] * a[0] + 4.0f * q[0] * q1q1 - 2.0f * q[1] * a[1];
+        s[1] = 4.0f * q[1] * q3q3 - 2.0f * q[3] * a[0] + 4.0f * q0q0 * q[1] - 2.0f * q[0] * a[1] - 4.0f * q[1]
+             + 8.0f * q[1] * q1q1 + 8.0f * q[1] * q2q2 + 4.0f * q[1] * a[2];
+        s[2] = 4.0f * q0q0 * q[2] + 2.0f * q[0] * a[0] + 4.0f * q[2] * q3q3 - 2.0f * q[3] * a[1] - 4.0f * q[2]
+             + 8.0f * q[2] * q1q1 + 8.0f * q[2] * q2q2 + 4.0f * q[2] * a[2];
+        s[3] = 4.0f * q1q1 * q[3] - 2.0f * q[1] * a[0] + 4.0f * q2q2 * q[3] - 2.0f * q[2] * a[1];
+        if(Normalize(s, 4)){
+            for(uint8_t i = 0; i < 4; i++){
+                qdot[i] -= filter->beta * s[i];
+            }
+        }
+    }
+    for(uint8_t i = 0; i < 4; i++){
+        q[i] += qdot[i] * dt;
+    }
+    Normalize(q, 4);
+}
+
+static void MahonyUpdate(imu_fusion_t *filter, const float *gyro, const float *accel, float dt){
+    float *q = filter->q;
+    float a[3] = {accel[0], accel[1], accel[2]};
+    float g[3] = {gyro[0], gyro[1], gyro[2]};
+    if(Normalize(a, 3)){
+        // Estimated gravity direction (half) and error with the measured one
+        float vx = q[1] * q[3] - q[0] * q[2];
+        float vy = q[0] * q[1] + q[2] * q[3];
+        float vz = q[0] * q[0] - 0.5f + q[3] * q[3];
+        float e[3] = {
+            a[1] * vz - a[2] * vy,
+            a[2] * vx - a[0] * vz,
+            a[0] * vy - a[1] * vx
+        };
+        for(uint8_t i = 0; i < 3; i++){
+            if(filter->ki > 0){
+                filter->integral[i] += 2.0f * filter->ki * e[i] * dt;
+                g[i] += filter->integral[i];
+            }
+            g[i] += 2.0f * filter->kp * e[i];
+        }
+    }
+    for(uint8_t i = 0; i < 3; i++){
+        g[i] *= 0.5f * dt;
+    }
+    float qa = q[0], qb = q[1], qc = q[2];
+    q[0] += -qb * g[0] - qc * g[1] - q[3] * g[2];
+    q[1] +=  qa * g[0] + qc * g[2] - q[3] * g[1];
+    q[2] +=  qa * g[1] - qb * g[2] + q[3] * g[0];
+    q[3] +=  qa * g[2] + qb * g[1] - qc * g[0];
+    Normalize(q, 4);
+}
+/*==================[external functions definition]==========================*/
+void MadgwickInit(imu_fusion_t *filter, float beta){
+    memset(filter, 0, sizeof(imu_fusion_t));
+    filter->type = FUSION_MADGWICK;
+    filter->q[0] = 1;
+    filter->beta = beta;
+    ImuFusionSetScale(filter, 16384.0f, 131.0f);
+}
+
+void MahonyInit(imu_fusion_t *filter, float kp, float ki){
+    memset(filter, 0, sizeof(imu_fusion_t));
+    filter->type = FUSION_MAHONY;
+    filter->q[0] = 1;
+    filter->kp = kp;
+    filter->ki = ki;
+    ImuFusionSetScale(filter, 16384.0f, 131.0f);
+}
+
+void ImuFusionSetScale(imu_fusion_t *filter, float accel_lsb, float gyro_lsb){
+    filter->accel_scale = 1.0f / accel_lsb;
+    filter->gyro_scale = DEG_TO_RAD / gyro_lsb;
+}
+
+void ImuFusionUpdate(imu_fusion_t *filter, const float *gyro, const float *accel, float dt){
+    DSP_PROF_BEGIN(prof_start);
+    if(filter->type == FUSION_MADGWICK){
+        MadgwickUpdate(filter, gyro, accel, dt);
+    } else {
+        MahonyUpdate(filter, gyro, accel, dt);
+    }
+    DSP_PROF_END(DSP_PROF_IMU_FUSION_UPDATE, prof_start);
+}
+
+void ImuFusionUpdateMotion6(imu_fusion_t *filter, int16_t ax, int16_t ay, int16_t az,
+                            int16_t gx, int16_t gy, int16_t gz, float dt){
+    float accel[3] = {ax * filter->accel_scale, ay * filter->accel_scale, az * filter->accel_scale};
+    float gyro[3] = {gx * filter->gyro_scale, gy * filter->gyro_scale, gz * filter->gyro_scale};
+    ImuFusionUpdate(filter, gyro, accel, dt);
+}
+
+void ImuFusionGetYawPitchRoll(const imu_fusion_t *filter, float *ypr){
+    const float *q = filter->q;
+    ypr[0] = atan2f(2.0f * (q[1] * q[2] + q[0] * q[3]), q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3]);
+    ypr[1] = -asinf(2.0f * (q[1] * q[3] - q[0] * q[2]));
+    ypr[2] = atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]), q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]);
+}
+/*==================[end of file]============================================*/
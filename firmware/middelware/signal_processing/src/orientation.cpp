@@ -0,0 +1,244 @@
+/**
+ * @file orientation.cpp
+ * @brief Attitude estimation service: MPU6050 FIFO + ekf_imu13states or imu_fusion
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <string.h>
+#include <math.h>
+#include "orientation.h"
+#include "ekf_imu13states.h"
+#include "mat_arena.h"
+#include "imu_fusion.h"
+#include "dsp_prof.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+extern "C" {
+#include "mpu6050.h"
+}
+/*==================[macros and definitions]=================================*/
+#define DEG_TO_RAD      (M_PI / 180.0f)
+#define MAGN_R          1000.0f     /*!< Magnetometer variance: the MPU6050 has no magnetometer */
+
+/**
+ * @brief Averaged batch of IMU samples (one filter update)
+ */
+typedef struct {
+	float gyro[3];          /*!< Angular rate in rad/s */
+	float accel[3];         /*!< Acceleration in g */
+	int64_t timestamp;      /*!< Time of the last sample in us */
+} imu_batch_t;
+/*==================[internal data declaration]==============================*/
+static orientation_filter_t fusion_type;
+static ekf_imu13states *ekf13 = NULL;
+static dspm::MatArena *ekf_arena = NULL;
+static imu_fusion_t fusion;
+static QueueHandle_t imu_mailbox = NULL;
+static float update_dt;
+static float accel_var;
+/* Latest-value slot: the writer fills the buffer that is not published and then publishes it */
+static attitude_t attitude_slot[2];
+static uint32_t attitude_seq = 0;
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief One EKF step: prediction with the gyroscope, correction with the accelerometer
+ */
+static void OrientationStep(ekf_imu13states *filter, float *gyro, const float *accel, float dt, float accel_r);
+
+/**
+ * @brief Initialize a filter of the given type (EKF instance allocated by the caller)
+ */
+static void OrientationFilterInit(orientation_filter_t type, ekf_imu13states *filter, imu_fusion_t *light);
+
+/**
+ * @brief MPU6050 FIFO callback: averages the batch and posts it to the orientation task
+ */
+static void OrientationFifo(mpu6050_sample_t *samples, uint8_t count, void *param);
+
+/**
+ * @brief Orientation task: runs the filter once per batch and publishes the attitude
+ */
+static void OrientationTask(void *pvParameters);
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void OrientationStep(ekf_imu13states *filter, float *gyro, const float *accel, float dt, float accel_r){
+    DSP_PROF_BEGIN(prof_start);
+    float accel_norm[3];
+    float magn[3];
+    float R[6] = {MAGN_R, MAGN_R, MAGN_R, accel_r, accel_r, accel_r};
+    float norm = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    filter->Process(gyro, dt);
+    if(norm == 0){
+        DSP_PROF_END(DSP_PROF_ORIENTATION_STEP, prof_start);
+        return;
+    }
+    for(int i = 0; i < 3; i++){
+        accel_norm[i] = accel[i] / norm;
+    }
+    // No magnetometer: the measurement equals the expected value (no heading correction)
+    dspm::Mat Re = ekf::quat2rotm(filter->X.data).t();
+    dspm::Mat magn_state(&filter->X.data[7], 3, 1);
+    dspm::Mat magn_offset(&filter->X.data[10], 3, 1);
+    dspm::Mat expected_magn(magn, 3, 1);
+    dspm::Mat::mult_add(Re, magn_state, magn_offset, expected_magn);
+    filter->UpdateRefMeasurement(accel_norm, magn, R);
+    DSP_PROF_END(DSP_PROF_ORIENTATION_STEP, prof_start);
+}
+
+static void OrientationFilterInit(orientation_filter_t type, ekf_imu13states *filter, imu_fusion_t *light){
+    if(type == ORIENTATION_EKF){
+        filter->Init();
+    } else if(type == ORIENTATION_MADGWICK){
+        MadgwickInit(light, MADGWICK_BETA_DEFAULT);
+    } else {
+        MahonyInit(light, MAHONY_KP_DEFAULT, MAHONY_KI_DEFAULT);
+    }
+}
+
+static void OrientationFifo(mpu6050_sample_t *samples, uint8_t count, void *param){
+    imu_batch_t batch = {};
+    for(uint8_t i = 0; i < count; i++){
+        for(int j = 0; j < 3; j++){
+            batch.gyro[j] += samples[i].gyro[j];
+            batch.accel[j] += samples[i].accel[j];
+        }
+    }
+    for(int j = 0; j < 3; j++){
+        batch.gyro[j] *= DEG_TO_RAD / count;
+        batch.accel[j] /= count;
+    }
+    batch.timestamp = samples[count - 1].timestamp;
+    // Only the newest batch matters if the filter falls behind
+    xQueueOverwrite(imu_mailbox, &batch);
+}
+
+static void OrientationTask(void *pvParameters){
+    imu_batch_t batch;
+    uint32_t updates = 0;
+    while(1){
+        if(xQueueReceive(imu_mailbox, &batch, portMAX_DELAY) == pdTRUE){
+            uint32_t next = attitude_seq + 1;
+            attitude_t *att = &attitude_slot[next & 1];
+            if(fusion_type == ORIENTATION_EKF){
+                dspm::MatArenaScope scope(ekf_arena);
+                OrientationStep(ekf13, batch.gyro, batch.accel, update_dt, accel_var);
+                memcpy(att->q, ekf13->X.data, sizeof(att->q));
+                memcpy(att->gyro_bias, &ekf13->X.data[4], sizeof(att->gyro_bias));
+            } else {
+                ImuFusionUpdate(&fusion, batch.gyro, batch.accel, update_dt);
+                memcpy(att->q, fusion.q, sizeof(att->q));
+                for(int i = 0; i < 3; i++){
+                    att->gyro_bias[i] = -fusion.integral[i];
+                }
+            }
+            updates++;
+            att->timestamp = batch.timestamp;
+            att->updates = updates;
+            __atomic_store_n(&attitude_seq, next, __ATOMIC_RELEASE);
+        }
+    }
+}
+/*==================[external functions definition]==========================*/
+bool OrientationInit(orientation_config_t *config){
+    mpu6050_fifo_config_t fifo_config = {
+        .int_pin = config->int_pin,
+        .sample_rate = config->sample_rate,
+        .dlpf_mode = MPU6050_DLPF_BW_42,
+        .batch_size = 0,
+        .func_p = (void *)OrientationFifo,
+        .param_p = NULL,
+        .task_priority = (uint8_t)(config->task_priority + 1),
+    };
+    if((config->update_rate == 0) || (config->sample_rate % config->update_rate != 0)){
+        return false;
+    }
+    // Checked before the narrowing to the uint8_t batch size
+    uint16_t batch_size = config->sample_rate / config->update_rate;
+    if((batch_size == 0) || (batch_size > MPU6050_FIFO_MAX_SAMPLES)){
+        return false;
+    }
+    fifo_config.batch_size = (uint8_t)batch_size;
+    accel_var = (config->accel_r == 0) ? ORIENTATION_ACCEL_R : config->accel_r;
+    if(imu_mailbox == NULL){
+        fusion_type = config->filter;
+        if(fusion_type == ORIENTATION_EKF){
+            ekf13 = new ekf_imu13states();
+            ekf_arena = new dspm::MatArena(ORIENTATION_ARENA_SIZE);
+        }
+        OrientationFilterInit(fusion_type, ekf13, &fusion);
+        imu_mailbox = xQueueCreate(1, sizeof(imu_batch_t));
+        if((imu_mailbox == NULL) ||
+            (xTaskCreate(OrientationTask, "orientation", ORIENTATION_TASK_STACK, NULL, config->task_priority, NULL) != pdPASS)){
+            return false;
+        }
+    }
+    if(!MPU6050_fifoStart(&fifo_config)){
+        return false;
+    }
+    // Fixed dt: the actual sample period times the batch size
+    update_dt = MPU6050_fifoGetSamplePeriod() * fifo_config.batch_size / 1000000.0f;
+    return true;
+}
+
+bool OrientationGet(attitude_t *attitude){
+    uint32_t seq;
+    do {
+        seq = __atomic_load_n(&attitude_seq, __ATOMIC_ACQUIRE);
+        if(seq == 0){
+            return false;
+        }
+        *attitude = attitude_slot[seq & 1];
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        // Retry only if the writer reused this buffer while it was copied
+    } while(__atomic_load_n(&attitude_seq, __ATOMIC_RELAXED) != seq);
+    return true;
+}
+
+void OrientationBenchmark(orientation_filter_t filter_type, uint32_t iterations, orientation_bench_t *result){
+    ekf_imu13states *filter = (filter_type == ORIENTATION_EKF) ? new ekf_imu13states() : NULL;
+    dspm::MatArena *arena = (filter != NULL) ? new dspm::MatArena(ORIENTATION_ARENA_SIZE) : NULL;
+    imu_fusion_t light;
+    float gyro[3] = {0.01f, -0.02f, 0.005f};
+    float accel[3] = {0.02f, -0.01f, 0.98f};
+    uint32_t start, cycles;
+    uint64_t total = 0;
+    OrientationFilterInit(filter_type, filter, &light);
+    result->iterations = iterations;
+    result->min_cycles = UINT32_MAX;
+    result->max_cycles = 0;
+    for(uint32_t i = 0; i < iterations; i++){
+        start = esp_cpu_get_cycle_count();
+        if(filter != NULL){
+            dspm::MatArenaScope scope(arena);
+            OrientationStep(filter, gyro, accel, 0.01f, ORIENTATION_ACCEL_R);
+        } else {
+            ImuFusionUpdate(&light, gyro, accel, 0.01f);
+        }
+        cycles = esp_cpu_get_cycle_count() - start;
+        total += cycles;
+        if(cycles < result->min_cycles){
+            result->min_cycles = cycles;
+        }
+        if(cycles > result->max_cycles){
+            result->max_cycles = cycles;
+        }
+    }
+    result->avg_cycles = (iterations > 0) ? total / iterations : 0;
+    result->max_rate = (result->avg_cycles > 0) ? (esp_rom_get_cpu_ticks_per_us() * 1000000ULL) / result->avg_cycles : 0;
+    result->arena_peak = (arena != NULL) ? arena->peak() : 0;
+    result->arena_overflows = (arena != NULL) ? arena->overflows() : 0;
+    delete arena;
+    delete filter;
+}
+/*==================[end of file]============================================*/
@@ -0,0 +1,236 @@
+/**
+ * @file qrs_detector.c
+ * @brief Streaming Pan-Tompkins QRS detector
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <string.h>
+#include <math.h>
+#include "qrs_detector.h"
+#include "esp_dsp.h"
+#include "dsp_prof.h"
+/*==================[macros and definitions]=================================*/
+#define BAND_LOW        5.0f        /*!< Band-pass cut frequencies in Hz */
+#define BAND_HIGH       15.0f
+#define BAND_Q          (1 / 1.414) /*!< 2nd order Butterworth */
+#define WINDOW_S        0.150f      /*!< Integration window */
+#define REFRACTORY_S    0.200f
+#define T_WAVE_S        0.360f
+#define LEARN_S         2.0f
+#define SEARCH_BACK     1.66f       /*!< Search back after this many average RR intervals */
+#define CHUNK_LEN       32          /*!< Samples filtered per esp-dsp call */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Record a beat and fill the report
+ */
+static void QrsBeat(qrs_detector_t *qrs, uint32_t peak, uint32_t r, float slope, qrs_beat_t *beat);
+
+/**
+ * @brief Classify a peak of the integrated signal
+ * @return true if the peak is a beat
+ */
+static bool QrsPeak(qrs_detector_t *qrs, float peak, qrs_beat_t *beat);
+
+/**
+ * @brief Integration, peak detection and search back of one sample
+ * @return true if a beat was detected
+ */
+static bool QrsStep(qrs_detector_t *qrs, float filtered, float squared, qrs_beat_t *beat);
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void QrsBeat(qrs_detector_t *qrs, uint32_t peak, uint32_t r, float slope, qrs_beat_t *beat){
+    beat->sample = r;
+    beat->rr = 0;
+    beat->heart_rate = 0;
+    if(qrs->beat && r > qrs->last_r){
+        uint32_t rr = r - qrs->last_r;
+        beat->rr = rr / qrs->sample_freq;
+        beat->heart_rate = 60.0f / beat->rr;
+        qrs->rr[qrs->rr_pos] = rr;
+        qrs->rr_pos = (qrs->rr_pos + 1) % QRS_RR_AVERAGE;
+        if(qrs->rr_count < QRS_RR_AVERAGE){
+            qrs->rr_count++;
+        }
+        uint32_t sum = 0;
+        for(uint8_t i = 0; i < qrs->rr_count; i++){
+            sum += qrs->rr[i];
+        }
+        qrs->rr_average = (float)sum / qrs->rr_count;
+    }
+    qrs->beat = true;
+    qrs->last_peak = peak;
+    qrs->last_r = r;
+    qrs->last_slope = slope;
+    qrs->candidate = 0;
+}
+
+static bool QrsPeak(qrs_detector_t *qrs, float peak, qrs_beat_t *beat){
+    // The peak was the previous sample
+    uint32_t n = qrs->count - 1;
+    if(qrs->beat && (n - qrs->last_peak < qrs->refractory)){
+        return false;
+    }
+    // R peak: maximum of the band-passed signal over the window and the derivative delay
+    uint32_t r = qrs->count;
+    float r_max = -INFINITY;
+    uint16_t span = qrs->window + QRS_DERIVATIVE_LEN;
+    for(uint16_t k = 0; k < span; k++){
+        uint16_t i = (qrs->filtered_pos + QRS_HISTORY_LEN - 1 - k) % QRS_HISTORY_LEN;
+        if(qrs->filtered[i] > r_max){
+            r_max = qrs->filtered[i];
+            r = qrs->count - k;
+        }
+    }
+    // Slope: maximum of the squared derivative in the window
+    float slope = 0;
+    for(uint16_t i = 0; i < qrs->window; i++){
+        if(qrs->squared[i] > slope){
+            slope = qrs->squared[i];
+        }
+    }
+
+    bool detected = false;
+    if(peak > qrs->threshold1){
+        // Half the slope of the previous beat (a quarter squared) shortly after it: T wave
+        if(qrs->beat && (n - qrs->last_peak < qrs->t_wave) && (slope < 0.25f * qrs->last_slope)){
+            qrs->npki = 0.125f * peak + 0.875f * qrs->npki;
+        }
+        else{
+            qrs->spki = 0.125f * peak + 0.875f * qrs->spki;
+            QrsBeat(qrs, n, r, slope, beat);
+            detected = true;
+        }
+    }
+    else{
+        qrs->npki = 0.125f * peak + 0.875f * qrs->npki;
+        if((peak > qrs->threshold2) && (peak > qrs->candidate)){
+            qrs->candidate = peak;
+            qrs->candidate_peak = n;
+            qrs->candidate_r = r;
+            qrs->candidate_slope = slope;
+        }
+    }
+    qrs->threshold1 = qrs->npki + 0.25f * (qrs->spki - qrs->npki);
+    qrs->threshold2 = 0.5f * qrs->threshold1;
+    return detected;
+}
+
+static bool QrsStep(qrs_detector_t *qrs, float filtered, float squared, qrs_beat_t *beat){
+    bool detected = false;
+    qrs->filtered[qrs->filtered_pos] = filtered;
+    qrs->filtered_pos = (qrs->filtered_pos + 1) % QRS_HISTORY_LEN;
+    // Moving window integration with a running sum
+    qrs->mwi_sum += squared - qrs->squared[qrs->squared_pos];
+    qrs->squared[qrs->squared_pos] = squared;
+    if(++qrs->squared_pos >= qrs->window){
+        qrs->squared_pos = 0;
+        // Exact sum once per window: the running sum rounding error does not accumulate
+        qrs->mwi_sum = 0;
+        for(uint16_t i = 0; i < qrs->window; i++){
+            qrs->mwi_sum += qrs->squared[i];
+        }
+    }
+    float mwi = qrs->mwi_sum / qrs->window;
+
+    if(qrs->count < qrs->learn){
+        // Training: initial signal and noise levels
+        if(mwi > qrs->learn_max){
+            qrs->learn_max = mwi;
+        }
+        qrs->learn_sum += mwi;
+        if(qrs->count == qrs->learn - 1){
+            qrs->spki = qrs->learn_max / 3;
+            qrs->npki = qrs->learn_sum / qrs->learn / 2;
+            qrs->threshold1 = qrs->npki + 0.25f * (qrs->spki - qrs->npki);
+            qrs->threshold2 = 0.5f * qrs->threshold1;
+        }
+    }
+    else if(mwi < qrs->mwi_last){
+        if(qrs->rising){
+            detected = QrsPeak(qrs, qrs->mwi_last, beat);
+        }
+    }
+    qrs->rising = (mwi > qrs->mwi_last) || (qrs->rising && (mwi == qrs->mwi_last));
+    qrs->mwi_last = mwi;
+
+    // Search back: the highest noise peak above threshold2 after a long RR interval
+    if(!detected && (qrs->rr_average > 0) && (qrs->candidate > 0) &&
+       (qrs->count - qrs->last_peak > SEARCH_BACK * qrs->rr_average)){
+        qrs->spki = 0.25f * qrs->candidate + 0.75f * qrs->spki;
+        qrs->threshold1 = qrs->npki + 0.25f * (qrs->spki - qrs->npki);
+        qrs->threshold2 = 0.5f * qrs->threshold1;
+        QrsBeat(qrs, qrs->candidate_peak, qrs->candidate_r, qrs->candidate_slope, beat);
+        detected = true;
+    }
+    qrs->count++;
+    return detected;
+}
+/*==================[external functions definition]==========================*/
+bool QrsInit(qrs_detector_t *qrs, float sample_freq){
+    if((sample_freq < QRS_FREQ_MIN) || (sample_freq > QRS_FREQ_MAX)){
+        return false;
+    }
+    memset(qrs, 0, sizeof(qrs_detector_t));
+    qrs->sample_freq = sample_freq;
+    qrs->window = lroundf(WINDOW_S * sample_freq);
+    qrs->refractory = lroundf(REFRACTORY_S * sample_freq);
+    qrs->t_wave = lroundf(T_WAVE_S * sample_freq);
+    qrs->learn = lroundf(LEARN_S * sample_freq);
+    dsps_biquad_gen_hpf_f32(qrs->hp_coeffs, BAND_LOW / sample_freq, BAND_Q);
+    dsps_biquad_gen_lpf_f32(qrs->lp_coeffs, BAND_HIGH / sample_freq, BAND_Q);
+    // y[n] = fs / 8 * (2 x[n] + x[n - 1] - x[n - 3] - 2 x[n - 4]), esp-dsp takes the
+    // coefficients oldest sample first
+    float k = sample_freq / 8;
+    float derivative[5] = {-2 * k, -k, 0, k, 2 * k};
+    memcpy(&qrs->derivative_coeffs[QRS_DERIVATIVE_LEN - 5], derivative, sizeof(derivative));
+    dsps_fir_init_f32(&qrs->derivative, qrs->derivative_coeffs, qrs->derivative_delay, QRS_DERIVATIVE_LEN);
+    return true;
+}
+
+uint8_t QrsProcess(qrs_detector_t *qrs, const float *signal, uint16_t signal_lenght,
+                   qrs_beat_t *beats, uint8_t max_beats){
+    DSP_PROF_BEGIN(prof_start);
+    float filtered[CHUNK_LEN];
+    float squared[CHUNK_LEN];
+    uint8_t n_beats = 0;
+    if((qrs->count == 0) && (signal_lenght > 0)){
+        // High pass state in steady state for the first sample: no DC step transient
+        float w = signal[0] / (1 + qrs->hp_coeffs[3] + qrs->hp_coeffs[4]);
+        qrs->hp_delay[0] = w;
+        qrs->hp_delay[1] = w;
+    }
+    for(uint16_t i = 0; i < signal_lenght; i += CHUNK_LEN){
+        int len = (signal_lenght - i < CHUNK_LEN) ? (signal_lenght - i) : CHUNK_LEN;
+        dsps_biquad_f32_auto(&signal[i], filtered, len, qrs->hp_coeffs, qrs->hp_delay);
+        dsps_biquad_f32_auto(filtered, filtered, len, qrs->lp_coeffs, qrs->lp_delay);
+        dsps_fir_f32(&qrs->derivative, filtered, squared, len);
+        dsps_mul_f32_auto(squared, squared, squared, len, 1, 1, 1);
+        for(int j = 0; j < len; j++){
+            qrs_beat_t beat;
+            if(QrsStep(qrs, filtered[j], squared[j], &beat) && (n_beats < max_beats)){
+                beats[n_beats++] = beat;
+            }
+        }
+    }
+    DSP_PROF_END(DSP_PROF_QRS_PROCESS, prof_start);
+    return n_beats;
+}
+
+float QrsHeartRate(const qrs_detector_t *qrs){
+    if(qrs->rr_average == 0){
+        return 0;
+    }
+    return 60.0f * qrs->sample_freq / qrs->rr_average;
+}
+
+/*==================[end of file]============================================*/
@@ -3,7 +3,9 @@
  * @section genDesc General Description
  *
  *  Este programa está diseñado para medir señales analógicas desde un canal, 
- *  convertirlas a valores digitales y enviarlas mediante UART.
+ *  convertirlas a valores digitales y detectar los complejos QRS de la señal de ECG
+ *  (algoritmo de Pan-Tompkins, qrs_detector.h). Por UART se envía solo cada latido
+ *  detectado: el instante del pico R en ms y la frecuencia cardíaca instantánea.
  *  Por otra parte, genera una señal de ECG simulada con los datos otorgados por la cátedra,
  *  que es enviada como salida analógica.
  * En este proyecto se realiza tanto conversión analógica-digital como digital-analógica
@@ -23,6 +25,7 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 03/10/2024 | Document creation		                         |
+ * | 19/10/2026 | Detección de QRS y envío de latidos por UART   |
  *
  * @author Lonardi, Paula (paula.lonardi@ingenieria.uner.edu.ar)
  *
@@ -38,11 +41,15 @@
 #include "timer_mcu.h"
 #include "analog_io_mcu.h"
 #include "uart_mcu.h"
+#include "qrs_detector.h"
 
 /*==================[macros and definitions]=================================*/
-#define CONFIG_BLINK_PERIOD_TAREA_MEDIR_Y_ENVIAR_US 20000
+#define CONFIG_BLINK_PERIOD_TAREA_MEDIR_Y_ENVIAR_US 5000
+#define FRECUENCIA_MUESTREO (1000000 / CONFIG_BLINK_PERIOD_TAREA_MEDIR_Y_ENVIAR_US)
 #define CONFIG_BLINK_PERIOD_ECG 10000
 #define TAMANIO_DE_BUFER 231
+#define TAMANIO_BLOQUE 50 /* 250 ms de señal por bloque procesado */
+#define MAX_LATIDOS 4
 
 /*==================[internal data definition]===============================*/
 /**
@@ -51,6 +58,11 @@
 TaskHandle_t handle_tarea_medir_enviar = NULL;
 TaskHandle_t handle_main = NULL;
 
+/**
+ * @brief Estado del detector de QRS.
+ */
+qrs_detector_t detector_qrs;
+
 /**
  * @brief Buffer con datos de una simulacion de ECG
  */
@@ -78,26 +90,40 @@ uint8_t ecg[TAMANIO_DE_BUFER] = {
 /*==================[internal functions declaration]=========================*/
 
 /**
- * @brief Tarea de medición y envío de datos.
+ * @brief Tarea de medición, detección de QRS y envío de latidos.
  * 
- * Esta TAREA mide continuamente un valor analógico desde el canal CH1, lo convierte a un valor 
- * digital y lo envía mediante UART. 
+ * Esta TAREA mide continuamente un valor analógico desde el canal CH1 a FRECUENCIA_MUESTREO,
+ * acumula las muestras en un bloque y procesa cada bloque completo con el detector de QRS.
+ * Por cada latido detectado envía mediante UART "R:<instante del pico R en ms> FC:<lpm>".
  * La tarea espera en un bucle hasta recibir una notificación para continuar.
  *
  * @param[in] pvParameter Parámetro de entrada para la tarea (no lo utilizo).
  * 
  * El funcionamiento de la tarea es el siguiente:
- * - Lee un valor analógico usando `AnalogInputReadSingle`.
- * - Convierte el valor a cadena con `UartItoa` y lo envía mediante UART usando `UartSendString`.
+ * - Lee un valor analógico usando `AnalogInputReadSingle` y lo guarda en el bloque.
+ * - Con el bloque completo llama a `QrsProcess` y envía los latidos mediante UART usando `UartSendString`.
  * - Espera una notificación mediante `ulTaskNotifyTake` antes de continuar con la siguiente medición.
  */
 void tarea_medir_enviar(void *pvParameter){
 	uint16_t valor_medida;
+	float bloque[TAMANIO_BLOQUE];
+	qrs_beat_t latidos[MAX_LATIDOS];
+	uint8_t n = 0;
 	while (1)
 	{ 
-		AnalogInputReadSingle(CH1, &valor_medida);//lee y devuelve el valor digitalizado
-		UartSendString(UART_PC, (const char*)UartItoa(valor_medida, 10)); // Paso la cadena a un valor y envío a través de UART
-		UartSendString(UART_PC, "\r");
+		AnalogInputReadSingle(CH1, &valor_medida);//lee y devuelve el valor digitalizado en mV
+		bloque[n++] = valor_medida;
+		if(n == TAMANIO_BLOQUE){
+			n = 0;
+			uint8_t cantidad = QrsProcess(&detector_qrs, bloque, TAMANIO_BLOQUE, latidos, MAX_LATIDOS);
+			for(uint8_t i = 0; i < cantidad; i++){
+				UartSendString(UART_PC, "R:");
+				UartSendString(UART_PC, (const char*)UartItoa((uint64_t)latidos[i].sample * 1000 / FRECUENCIA_MUESTREO, 10));
+				UartSendString(UART_PC, " FC:");
+				UartSendString(UART_PC, (const char*)UartItoa((uint32_t)(latidos[i].heart_rate + 0.5f), 10));
+				UartSendString(UART_PC, "\r\n");
+			}
+		}
 		ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // La tarea espera en este punto hasta recibir una notificación
 	}
 }
@@ -168,7 +194,7 @@ void app_main(void){
 
 	serial_config_t my_uart = {
 		.port = UART_PC, 
-		.baud_rate = 38400, //(1/38400)*50 < 20ms de muestreo
+		.baud_rate = 38400, //~15 caracteres por latido detectado
 		.func_p = NULL, 
 		.param_p = NULL
 	};
@@ -185,6 +211,7 @@ void app_main(void){
 
 	AnalogInputInit(&analog);
 	AnalogOutputInit();
+	QrsInit(&detector_qrs, FRECUENCIA_MUESTREO);
 
 
 	/* Inicialización de timers */
@@ -208,7 +235,7 @@ void app_main(void){
 
     TimerInit(&timer_ecg);
 
-	xTaskCreate(&tarea_medir_enviar, "medicion",2048, NULL,5,&handle_tarea_medir_enviar);
+	xTaskCreate(&tarea_medir_enviar, "medicion",4096, NULL,5,&handle_tarea_medir_enviar);
 	xTaskCreate(&tarea_ecg, "tarea_ECG",2048, NULL,5,&handle_main);
 
 	TimerStart(timer_medir_y_enviar.timer);